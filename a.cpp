@@ -1,21 +1,41 @@
 #include <SDL2/SDL.h>
-#include <deque>
 #include <vector>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <iostream>
-#include <SDL2/SDL_ttf.h>
+#if defined(SNAKE_ALLOC_TRACK) && !defined(SNAKE_NO_MAIN)
+#define ALLOC_TRACK_IMPLEMENTATION
+#endif
+#include "alloctrack.h"
+#include "geometry.h"
 using namespace std;
 
 const int WINDOW_WIDTH = 640;
 const int WINDOW_HEIGHT = 440;
 const int TILE_SIZE = 20;
 
+// The rules work on tile indices of a 32 x 22 board. Pixels only appear when
+// drawing, through tileRect(), and in the obstacles, which are drawn where
+// they always were: the bar sits half a tile off the grid, and blocks both
+// rows it overlaps.
+using BoardGeometry = FixedGeometry<WINDOW_WIDTH / TILE_SIZE, WINDOW_HEIGHT / TILE_SIZE>;
+using Tile = BoardGeometry::Index;
+
+constexpr SDL_Rect tileRect(Tile t) { return BoardGeometry::toRect(t, TILE_SIZE); }
+
 enum Direction { UP, DOWN, LEFT, RIGHT };
 
+// RENDER_DIRTY repaints only the tiles that changed since the last frame. With
+// the software renderer it drops the renderer and fills the window surface
+// itself, sending just those tiles to the screen; an accelerated renderer keeps
+// the frame in a target texture instead. RENDER_AUTO picks it for the software
+// renderer, where every filled pixel costs CPU time.
+enum RenderMode { RENDER_FULL, RENDER_DIRTY, RENDER_AUTO };
+
 class SnakeGame {
 public:
-    SnakeGame() : direction(RIGHT), snakeSize(1), score(0) {
+    explicit SnakeGame(RenderMode mode = RENDER_AUTO) : direction(RIGHT), snakeSize(1), score(0) {
         if (SDL_Init(SDL_INIT_VIDEO) < 0) {
             cerr << "Failed to initialize SDL: " << SDL_GetError() << std::endl;
             exit(1);
@@ -23,8 +43,10 @@ public:
 
         window = SDL_CreateWindow("Snake Game", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_SHOWN);
         renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+        chooseRenderMode(mode);
 
-        snakeHead = {0, WINDOW_HEIGHT / 2, TILE_SIZE, TILE_SIZE};
+        snakeHead = BoardGeometry::index(0, BoardGeometry::rows / 2);
+        snakeBody.reserve(BoardGeometry::cells); // never reallocates while playing
         snakeBody.push_back(snakeHead);
 
         srand(static_cast<unsigned>(time(0)));
@@ -33,7 +55,8 @@ public:
     }
 
     ~SnakeGame() {
-        SDL_DestroyRenderer(renderer);
+        if (canvas) SDL_DestroyTexture(canvas);
+        if (renderer) SDL_DestroyRenderer(renderer);
         SDL_DestroyWindow(window);
         SDL_Quit();
     }
@@ -41,6 +64,7 @@ public:
     void run() {
         bool running = true;
         SDL_Event event;
+        unsigned long long tick = 0;
 
         while (running) {
             while (SDL_PollEvent(&event)) {
@@ -48,35 +72,105 @@ public:
                     running = false;
                 } else if (event.type == SDL_KEYDOWN) {
                     handleDirection(event.key.keysym.sym);
+                } else if (event.type == SDL_RENDER_DEVICE_RESET) {
+                    // The canvas went with the device; render() makes a new one.
+                    if (canvas) SDL_DestroyTexture(canvas);
+                    canvas = nullptr;
+                    fullRedraw = true;
+                } else if (event.type == SDL_RENDER_TARGETS_RESET ||
+                           (event.type == SDL_WINDOWEVENT && (event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED ||
+                                                              event.window.event == SDL_WINDOWEVENT_EXPOSED))) {
+                    fullRedraw = true; // the canvas or the window surface is stale
                 }
             }
 
             update();
+            ALLOC_REPORT("update", tick);
             render();
+            ALLOC_REPORT("render", tick);
+            tick++;
             SDL_Delay(150);
         }
     }
 
 private:
+    friend struct SnakeGameBench;
+
     SDL_Window* window;
-    SDL_Renderer* renderer;
-    SDL_Rect snakeHead;
-    deque<SDL_Rect> snakeBody;
-    SDL_Rect apple;
-    std::vector<SDL_Rect> obstacles; // List of obstacles
+    SDL_Renderer* renderer; // null when drawing into the window surface
+    Tile snakeHead;
+    vector<Tile> snakeBody; // head first
+    Tile apple = 0;
+    std::vector<SDL_Rect> obstacles; // List of obstacles, in pixels
+    BoardGeometry::Grid<bool> obstacleTiles{}; // every tile an obstacle overlaps
     Direction direction;
     int snakeSize;
     int score;
 
+    // Dirty-rectangle rendering; see RenderMode.
+    bool dirtyRendering = false;
+    SDL_Surface* surface = nullptr; // the window's, with the software renderer
+    SDL_Texture* canvas = nullptr;  // otherwise
+    bool fullRedraw = true;
+    static const size_t MAX_DIRTY = 8; // head, tail and two apples per tick
+    vector<Tile> dirtyTiles;
+
+    void chooseRenderMode(RenderMode mode) {
+        SDL_RendererInfo info;
+        bool software = SDL_GetRendererInfo(renderer, &info) == 0 && (info.flags & SDL_RENDERER_SOFTWARE);
+        if (mode == RENDER_AUTO) mode = software ? RENDER_DIRTY : RENDER_FULL;
+        dirtyTiles.reserve(MAX_DIRTY);
+        if (mode != RENDER_DIRTY) return;
+
+        if (software) {
+            // SDL won't hand out the window surface while a renderer uses it.
+            SDL_DestroyRenderer(renderer);
+            renderer = nullptr;
+            surface = SDL_GetWindowSurface(window);
+            if (!surface) {
+                renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+                return;
+            }
+            dirtyRendering = true;
+        } else {
+            dirtyRendering = SDL_RenderTargetSupported(renderer);
+        }
+    }
+
+    // Fills rect, or the whole frame if it is null, on whichever of the
+    // renderer or the window surface is in use.
+    void fill(const SDL_Rect* rect, Uint8 r, Uint8 g, Uint8 b) {
+        if (surface) {
+            SDL_FillRect(surface, rect, SDL_MapRGB(surface->format, r, g, b));
+            return;
+        }
+        SDL_SetRenderDrawColor(renderer, r, g, b, 255);
+        if (rect) SDL_RenderFillRect(renderer, rect);
+        else SDL_RenderClear(renderer);
+    }
+
+    // A tile to repaint next frame. If frames were skipped and the list is
+    // full, the next frame is redrawn in full instead.
+    void markDirty(Tile tile) {
+        if (!dirtyRendering) return;
+        if (dirtyTiles.size() < MAX_DIRTY) dirtyTiles.push_back(tile);
+        else fullRedraw = true;
+    }
+
     void initializeObstacles() {
         SDL_Rect obstacle1 = {WINDOW_WIDTH / 4, WINDOW_HEIGHT / 4, TILE_SIZE * 5, TILE_SIZE}; // Horizontal obstacle
         SDL_Rect obstacle2 = {WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2, TILE_SIZE, TILE_SIZE * 5}; // Vertical obstacle
         obstacles.push_back(obstacle1);
         obstacles.push_back(obstacle2);
+        markObstacleTiles();
     }
 
-    int getRandomCoord() {
-        return (rand() % (WINDOW_WIDTH / TILE_SIZE)) * TILE_SIZE;
+    void markObstacleTiles() {
+        obstacleTiles.fill(false);
+        for (const auto& obstacle : obstacles)
+            for (int y = obstacle.y / TILE_SIZE; y <= (obstacle.y + obstacle.h - 1) / TILE_SIZE; ++y)
+                for (int x = obstacle.x / TILE_SIZE; x <= (obstacle.x + obstacle.w - 1) / TILE_SIZE; ++x)
+                    if (BoardGeometry::inside(x, y)) obstacleTiles[BoardGeometry::index(x, y)] = true;
     }
 
     void handleDirection(SDL_Keycode key) {
@@ -97,70 +191,136 @@ private:
     }
 
     void update() {
+        int x = BoardGeometry::x(snakeHead), y = BoardGeometry::y(snakeHead);
         switch (direction) {
-            case UP:    snakeHead.y -= TILE_SIZE; break;
-            case DOWN:  snakeHead.y += TILE_SIZE; break;
-            case LEFT:  snakeHead.x -= TILE_SIZE; break;
-            case RIGHT: snakeHead.x += TILE_SIZE; break;
+            case UP:    y--; break;
+            case DOWN:  y++; break;
+            case LEFT:  x--; break;
+            case RIGHT: x++; break;
         }
 
-        if (snakeHead.x < 0 || snakeHead.y < 0 || 
-            snakeHead.x >= WINDOW_WIDTH || snakeHead.y >= WINDOW_HEIGHT) {
+        if (!BoardGeometry::inside(x, y)) {
             gameOver();
             return;
         }
+        snakeHead = BoardGeometry::index(x, y);
 
-        for (const auto& segment : snakeBody) {
-            if (snakeHead.x == segment.x && snakeHead.y == segment.y) {
+        for (Tile segment : snakeBody) {
+            if (snakeHead == segment) {
                 gameOver();
                 return;
             }
         }
 
-        for (const auto& obstacle : obstacles) {
-            if (SDL_HasIntersection(&snakeHead, &obstacle)) {
-                pauseGame();
-                return;
-            }
+        if (obstacleTiles[snakeHead]) {
+            pauseGame();
+            return;
         }
 
-        if (snakeHead.x == apple.x && snakeHead.y == apple.y) {
+        if (snakeHead == apple) {
             score++;
             snakeSize++;
             generateApple();
         }
 
-        snakeBody.push_front(snakeHead);
+        snakeBody.insert(snakeBody.begin(), snakeHead);
+        markDirty(snakeHead);
         while (snakeBody.size() > static_cast<size_t>(snakeSize)) {
+            markDirty(snakeBody.back());
             snakeBody.pop_back();
         }
     }
 
     void render() {
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
+        if (!dirtyRendering) {
+            drawScene();
+            SDL_RenderPresent(renderer);
+            return;
+        }
+
+        if (surface) {
+            if (fullRedraw) {
+                surface = SDL_GetWindowSurface(window); // a resize replaces it
+                if (!surface) return;
+                drawScene();
+                SDL_UpdateWindowSurface(window);
+                fullRedraw = false;
+            } else if (!dirtyTiles.empty()) {
+                SDL_Rect rects[MAX_DIRTY];
+                for (size_t i = 0; i < dirtyTiles.size(); ++i) {
+                    repaintTile(dirtyTiles[i]);
+                    rects[i] = tileRect(dirtyTiles[i]);
+                }
+                SDL_UpdateWindowSurfaceRects(window, rects, static_cast<int>(dirtyTiles.size()));
+            }
+            dirtyTiles.clear();
+            return;
+        }
 
-        SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-        SDL_RenderFillRect(renderer, &apple);
+        if (!canvas) {
+            canvas = SDL_CreateTexture(renderer, SDL_GetWindowPixelFormat(window), SDL_TEXTUREACCESS_TARGET, WINDOW_WIDTH, WINDOW_HEIGHT);
+            if (!canvas) {
+                dirtyRendering = false; // no render targets after all
+                render();
+                return;
+            }
+        }
 
-        SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-        for (const auto& segment : snakeBody) {
-            SDL_RenderFillRect(renderer, &segment);
+        SDL_SetRenderTarget(renderer, canvas);
+        if (fullRedraw) {
+            drawScene();
+            fullRedraw = false;
+        } else {
+            for (const auto& tile : dirtyTiles) repaintTile(tile);
         }
+        dirtyTiles.clear();
+        SDL_SetRenderTarget(renderer, nullptr);
+        SDL_RenderCopy(renderer, canvas, nullptr, nullptr);
+        SDL_RenderPresent(renderer);
+    }
 
-        SDL_SetRenderDrawColor(renderer, 0, 80, 70, 255);
+    // Clears the current target and draws everything.
+    void drawScene() {
+        fill(nullptr, 0, 0, 0);
+        SDL_Rect rect = tileRect(apple);
+        fill(&rect, 255, 0, 0);
+        for (Tile segment : snakeBody) {
+            rect = tileRect(segment);
+            fill(&rect, 0, 255, 0);
+        }
         for (const auto& obstacle : obstacles) {
-            SDL_RenderFillRect(renderer, &obstacle);
+            fill(&obstacle, 0, 80, 70);
         }
+    }
 
-        SDL_RenderPresent(renderer);
+    // Redraws one tile as drawScene() would, in the same order.
+    void repaintTile(Tile tile) {
+        const SDL_Rect rect = tileRect(tile);
+        fill(&rect, 0, 0, 0);
+
+        if (apple == tile) {
+            fill(&rect, 255, 0, 0);
+        }
+
+        for (Tile segment : snakeBody) {
+            if (segment == tile) {
+                fill(&rect, 0, 255, 0);
+                break;
+            }
+        }
+
+        SDL_Rect overlap;
+        for (const auto& obstacle : obstacles) {
+            if (SDL_IntersectRect(&rect, &obstacle, &overlap)) {
+                fill(&overlap, 0, 80, 70);
+            }
+        }
     }
 
     void generateApple() {
-        apple.x = (rand() % ((WINDOW_WIDTH / TILE_SIZE) - 1)) * TILE_SIZE;
-        apple.y = (rand() % ((WINDOW_HEIGHT / TILE_SIZE) - 1)) * TILE_SIZE;
-        apple.w = TILE_SIZE;
-        apple.h = TILE_SIZE;
+        markDirty(apple);
+        apple = BoardGeometry::index(rand() % (BoardGeometry::cols - 1), rand() % (BoardGeometry::rows - 1));
+        markDirty(apple);
     }
 
     void pauseGame() {
@@ -189,17 +349,28 @@ private:
 
     void gameOver() {
         cout << "Game Over! Your Score: " << score << endl;
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
-        SDL_RenderPresent(renderer);
+        fill(nullptr, 0, 0, 0);
+        if (surface) SDL_UpdateWindowSurface(window);
+        else SDL_RenderPresent(renderer);
         SDL_Delay(1000);
         SDL_Quit();
         exit(0);
     }
 };
 
+#ifndef SNAKE_NO_MAIN
+// --full-redraw and --dirty-rects override the renderer-based default.
 int SDL_main(int argc, char* argv[]) {
-    SnakeGame game;
+#ifdef SNAKE_ALLOC_TRACK
+    trackSDLAllocations();
+#endif
+    RenderMode mode = RENDER_AUTO;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--full-redraw") == 0) mode = RENDER_FULL;
+        else if (strcmp(argv[i], "--dirty-rects") == 0) mode = RENDER_DIRTY;
+    }
+    SnakeGame game(mode);
     game.run();
     return 0;
 }
+#endif
@@ -0,0 +1,94 @@
+// Debug heap allocation counter.
+//
+// Counts allocations made through the global operator new and, after
+// trackSDLAllocations(), through SDL_malloc/SDL_calloc/SDL_realloc (which SDL
+// and SDL_ttf use for surfaces, textures and render queues).
+//
+// The replacement operator new/delete are only compiled into the one
+// translation unit that defines ALLOC_TRACK_IMPLEMENTATION before including
+// this header; the games do that when built with -DSNAKE_ALLOC_TRACK.
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+inline std::atomic<unsigned long long> allocCount{0};
+inline std::atomic<unsigned long long> freeCount{0};
+
+// Total allocations so far; subtract two calls to count a stretch of code.
+inline unsigned long long allocations() {
+    return allocCount.load(std::memory_order_relaxed);
+}
+
+namespace alloctrack {
+inline SDL_malloc_func sdlMalloc;
+inline SDL_calloc_func sdlCalloc;
+inline SDL_realloc_func sdlRealloc;
+inline SDL_free_func sdlFree;
+
+inline void* SDLCALL countingMalloc(size_t size) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    return sdlMalloc(size);
+}
+inline void* SDLCALL countingCalloc(size_t n, size_t size) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    return sdlCalloc(n, size);
+}
+inline void* SDLCALL countingRealloc(void* p, size_t size) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    return sdlRealloc(p, size);
+}
+inline void SDLCALL countingFree(void* p) {
+    if (p) freeCount.fetch_add(1, std::memory_order_relaxed);
+    sdlFree(p);
+}
+} // namespace alloctrack
+
+// Routes SDL's allocator through the counters. Call before SDL_Init or any
+// other SDL call that may allocate.
+inline void trackSDLAllocations() {
+    using namespace alloctrack;
+    SDL_GetMemoryFunctions(&sdlMalloc, &sdlCalloc, &sdlRealloc, &sdlFree);
+    SDL_SetMemoryFunctions(countingMalloc, countingCalloc, countingRealloc, countingFree);
+}
+
+// Prints how many allocations happened since the previous report, if any.
+inline void reportAllocations(const char* what, unsigned long long tick) {
+    static unsigned long long last = 0;
+    unsigned long long now = allocations();
+    if (now != last) std::fprintf(stderr, "tick %llu: %llu allocation(s) in %s\n", tick, now - last, what);
+    last = now;
+}
+
+#ifdef SNAKE_ALLOC_TRACK
+#define ALLOC_REPORT(what, tick) reportAllocations(what, tick)
+#else
+#define ALLOC_REPORT(what, tick) ((void)0)
+#endif
+
+#ifdef ALLOC_TRACK_IMPLEMENTATION
+void* operator new(size_t size) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+void operator delete(void* p) noexcept {
+    if (p) freeCount.fetch_add(1, std::memory_order_relaxed);
+    std::free(p);
+}
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+void operator delete(void* p, size_t) noexcept {
+    operator delete(p);
+}
+void operator delete[](void* p, size_t) noexcept {
+    operator delete(p);
+}
+#endif
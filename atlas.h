@@ -0,0 +1,197 @@
+// Texture atlas packed at startup, and a batcher that draws any number of
+// its sprites with a single SDL_RenderGeometry call.
+//
+// Sprites are added as RGBA32 pixels (bytes R, G, B, A) and packed into one
+// texture by build(), or pack() and upload(), in shelves sorted by height.
+// Each sprite gets a one-pixel border copied from its edges so linear
+// filtering never samples a neighbour.
+//
+// A SpriteBatch collects textured quads for a frame, optionally turned by
+// quarter turns, and flush() hands them all to SDL at once, so the number of
+// draw calls does not depend on how many sprites there are.
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+class SpriteAtlas {
+public:
+    struct Region {
+        float u0, v0, u1, v1;
+    };
+
+    SpriteAtlas() = default;
+    ~SpriteAtlas() {
+        if (tex) SDL_DestroyTexture(tex);
+    }
+
+    SpriteAtlas(const SpriteAtlas&) = delete;
+    SpriteAtlas& operator=(const SpriteAtlas&) = delete;
+
+    // Copies a width x height image; returns its sprite id. Call before
+    // pack().
+    int add(const void *rgba, int width, int height, int pitch) {
+        Image image{width, height, std::vector<uint8_t>(size_t(width) * height * 4)};
+        for (int y = 0; y < height; ++y)
+            std::memcpy(image.pixels.data() + size_t(y) * width * 4, static_cast<const uint8_t *>(rgba) + size_t(y) * pitch,
+                        size_t(width) * 4);
+        images.push_back(std::move(image));
+        return static_cast<int>(images.size() - 1);
+    }
+
+    // Any SDL surface, converted to RGBA32. Returns -1 if it cannot be.
+    int add(SDL_Surface *surface) {
+        SDL_Surface *rgba = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGBA32, 0);
+        if (!rgba) return -1;
+        SDL_LockSurface(rgba);
+        int id = add(rgba->pixels, rgba->w, rgba->h, rgba->pitch);
+        SDL_UnlockSurface(rgba);
+        SDL_FreeSurface(rgba);
+        return id;
+    }
+
+    // Packs the added sprites into the smallest square power-of-two texture
+    // (up to 4096) that holds them and uploads it. Returns false if they do
+    // not fit or SDL fails; see SDL_GetError().
+    bool build(SDL_Renderer *renderer) { return pack() && upload(renderer); }
+
+    // build() in two steps: pack() needs no renderer, so it can run on a
+    // loading thread, while upload() belongs on the render thread.
+    bool pack() {
+        std::vector<SDL_Rect> places(images.size());
+        int size = 64;
+        while (!place(size, places))
+            if ((size *= 2) > 4096) return false;
+
+        packed.assign(size_t(size) * size * 4, 0);
+        for (size_t i = 0; i < images.size(); ++i) blit(packed, size, images[i], places[i]);
+
+        regions.resize(images.size());
+        for (size_t i = 0; i < images.size(); ++i) {
+            const SDL_Rect &p = places[i];
+            regions[i] = {float(p.x) / size, float(p.y) / size, float(p.x + p.w) / size, float(p.y + p.h) / size};
+        }
+        side = size;
+        images.clear();
+        images.shrink_to_fit();
+        return true;
+    }
+
+    bool upload(SDL_Renderer *renderer) {
+        if (tex) SDL_DestroyTexture(tex);
+        tex = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, side, side);
+        if (!tex || SDL_UpdateTexture(tex, nullptr, packed.data(), side * 4) != 0) return false;
+        SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+        packed.clear();
+        packed.shrink_to_fit();
+        return true;
+    }
+
+    SDL_Texture *texture() const { return tex; }
+    int size() const { return side; }
+    int spriteCount() const { return static_cast<int>(regions.size()); }
+    const Region &region(int sprite) const { return regions[sprite]; }
+
+private:
+    struct Image {
+        int w, h;
+        std::vector<uint8_t> pixels;
+    };
+
+    // Shelf packing, tallest first; places get the sprites' own rectangles,
+    // inside their borders.
+    bool place(int size, std::vector<SDL_Rect> &places) const {
+        std::vector<size_t> order(images.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return images[a].h > images[b].h; });
+
+        int x = 0, y = 0, shelf = 0;
+        for (size_t i : order) {
+            int w = images[i].w + 2, h = images[i].h + 2;
+            if (w > size) return false;
+            if (x + w > size) {
+                x = 0;
+                y += shelf;
+                shelf = 0;
+            }
+            if (y + h > size) return false;
+            places[i] = {x + 1, y + 1, images[i].w, images[i].h};
+            x += w;
+            shelf = std::max(shelf, h);
+        }
+        return true;
+    }
+
+    // Copies the image to place and repeats its outermost pixels into the
+    // border around it.
+    static void blit(std::vector<uint8_t> &atlas, int size, const Image &image, const SDL_Rect &place) {
+        auto at = [&](int x, int y) { return atlas.data() + (size_t(y) * size + x) * 4; };
+        for (int y = -1; y <= image.h; ++y) {
+            int sy = std::min(std::max(y, 0), image.h - 1);
+            const uint8_t *src = image.pixels.data() + size_t(sy) * image.w * 4;
+            std::memcpy(at(place.x, place.y + y), src, size_t(image.w) * 4);
+            std::memcpy(at(place.x - 1, place.y + y), src, 4);
+            std::memcpy(at(place.x + image.w, place.y + y), src + size_t(image.w - 1) * 4, 4);
+        }
+    }
+
+    std::vector<Image> images;   // until pack()
+    std::vector<uint8_t> packed; // from pack() to upload()
+    std::vector<Region> regions;
+    SDL_Texture *tex = nullptr;
+    int side = 0;
+};
+
+class SpriteBatch {
+public:
+    // Room for reserveSprites quads is allocated up front; a frame with more
+    // grows the buffers once.
+    explicit SpriteBatch(const SpriteAtlas &atlas, size_t reserveSprites = 1024) : atlas(atlas) {
+        vertices.reserve(reserveSprites * 4);
+        indices.reserve(reserveSprites * 6);
+    }
+
+    // Draws the sprite over dst, turned clockwise by quarterTurns, after
+    // mirroring it left to right when flip is set.
+    void add(int sprite, const SDL_Rect &dst, int quarterTurns = 0, bool flip = false) {
+        const SpriteAtlas::Region &r = atlas.region(sprite);
+        // Texture coordinates of the corners, clockwise from the top left.
+        const SDL_FPoint uv[4] = {{r.u0, r.v0}, {r.u1, r.v0}, {r.u1, r.v1}, {r.u0, r.v1}};
+        static const int mirrored[4] = {1, 0, 3, 2};
+        const float x0 = float(dst.x), y0 = float(dst.y), x1 = float(dst.x + dst.w), y1 = float(dst.y + dst.h);
+        const SDL_FPoint corners[4] = {{x0, y0}, {x1, y0}, {x1, y1}, {x0, y1}};
+
+        const size_t base = vertices.size(), first = indices.size();
+        vertices.resize(base + 4);
+        indices.resize(first + 6);
+        SDL_Vertex *v = vertices.data() + base;
+        for (int i = 0; i < 4; ++i) {
+            int source = (i - quarterTurns) & 3;
+            if (flip) source = mirrored[source];
+            v[i] = {corners[i], {255, 255, 255, 255}, uv[source]};
+        }
+        static const int quad[6] = {0, 1, 2, 0, 2, 3};
+        for (int i = 0; i < 6; ++i) indices[first + i] = static_cast<int>(base) + quad[i];
+    }
+
+    // One SDL_RenderGeometry call for everything added since the last flush.
+    // Returns the number of draw calls made (0 when there was nothing to draw).
+    int flush(SDL_Renderer *renderer) {
+        if (indices.empty()) return 0;
+        SDL_RenderGeometry(renderer, atlas.texture(), vertices.data(), static_cast<int>(vertices.size()), indices.data(),
+                           static_cast<int>(indices.size()));
+        vertices.clear();
+        indices.clear();
+        return 1;
+    }
+
+    size_t spriteCount() const { return vertices.size() / 4; }
+
+private:
+    const SpriteAtlas &atlas;
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+};
@@ -2,41 +2,105 @@
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_image.h>
 #include <bits/stdc++.h>
+#if defined(SNAKE_ALLOC_TRACK) && !defined(SNAKE_NO_MAIN)
+#define ALLOC_TRACK_IMPLEMENTATION
+#endif
+#include "alloctrack.h"
+#include "atlas.h"
+#include "clip.h"
+#include "font_arial28.h"
+#include "framearena.h"
+#include "geometry.h"
+#include "procstats.h"
+#include "replay.h"
+#include "screenshot.h"
+#include "softraster.h"
+#include "startup.h"
+#include "timerwheel.h"
 #undef main
 
 const int SCREEN_WIDTH = 1080;
 const int SCREEN_HEIGHT = 720;
 const int TILE_SIZE = 20;
+
+// The rules work on tile indices of a 54 x 36 board. Pixels only appear in
+// the renderers, through tileRect() and tilesToPixels().
+using BoardGeometry = FixedGeometry<SCREEN_WIDTH / TILE_SIZE, SCREEN_HEIGHT / TILE_SIZE>;
+using Tile = BoardGeometry::Index;
+const int HUD_ROWS = 4; // the score strip along the bottom
+const int PLAY_ROWS = BoardGeometry::rows - HUD_ROWS;
+
 int score = 0;
-int bonusFoodTimer = 0;
-bool pause = false;
+bool paused = false; // not `pause`, which clashes with pause() from <unistd.h>
 bool gameOver = false;
 bool quit = false;
 
+// In tiles. The first four are the inner walls; the rest frame the board and
+// cover the HUD strip.
+constexpr SDL_Rect WALLS[] = {
+    {28, 7, 1, 17},
+    {20, 15, 17, 1},
+    {5, 7, 1, 20},
+    {BoardGeometry::cols - 6, 7, 1, 20},
+    {0, PLAY_ROWS, BoardGeometry::cols, HUD_ROWS},
+    {0, 0, 1, BoardGeometry::rows},
+    {BoardGeometry::cols - 1, 0, 1, BoardGeometry::rows},
+    {0, 0, BoardGeometry::cols, 1},
+};
+
+// Every wall tile, worked out at compile time, so checkCollision() needs one
+// lookup for all of them.
+constexpr BoardGeometry::Grid<bool> wallTiles() {
+    BoardGeometry::Grid<bool> grid{};
+    for (const SDL_Rect &w : WALLS)
+        for (int y = w.y; y < w.y + w.h; ++y)
+            for (int x = w.x; x < w.x + w.w; ++x) grid[BoardGeometry::index(x, y)] = true;
+    return grid;
+}
+constexpr BoardGeometry::Grid<bool> WALL_TILES = wallTiles();
+
+// Timed events, counted in moves so replays and paused games keep to them.
+enum class GameEvent : uint8_t { BONUS_EXPIRES };
+const int BONUS_MOVES = 70; // 7 s at a move every 100 ms
+
+// A tile in pixels, for the renderers. Replays already hold pixels.
+constexpr SDL_Rect tileRect(Tile t) { return BoardGeometry::toRect(t, TILE_SIZE); }
+inline const SDL_Rect &tileRect(const SDL_Rect &r) { return r; }
+
+struct Theme;
+
 class Snake {
 public:
     Snake();
     void handleInput(SDL_Event &e);
     void move();
     void render(SDL_Renderer *renderer);
+    void render(SoftFramebuffer &fb);
+    void render(SpriteBatch &batch, const Theme &theme);
+    void capture(ReplayState &state) const;
     bool checkCollision();
     std::vector<SDL_Point> recentPositions;
     void spawnFood();
     void drawWall();
 
 private:
-    SDL_Rect food;
-    std::vector<SDL_Rect> body;
+    friend struct SnakeBench;
+
+    Tile food;
+    std::vector<Tile> body; // head first
     int direction; // 0 up, 1 down, 2 left, 3 right
     bool bonusFoodActive;
-    SDL_Rect bonusFood;
+    Tile bonusFood;
+    TimerWheel<GameEvent> timers; // advanced once a move
+    TimerHandle bonusTimer;
 };
 
 Snake::Snake() {
-    SDL_Rect head = {60, 60, TILE_SIZE, TILE_SIZE}; // Start position
+    Tile head = BoardGeometry::index(3, 3); // Start position
+    body.reserve(BoardGeometry::cells); // never reallocates while playing
+    body.push_back(head);
+    body.push_back(head);
     body.push_back(head);
-    body.push_back({head.x, head.y, TILE_SIZE, TILE_SIZE});
-    body.push_back({head.x, head.y, TILE_SIZE, TILE_SIZE});
     direction = 3; // Moving right initially
     spawnFood();
     bonusFoodActive = false;
@@ -48,22 +112,22 @@ void Snake::handleInput(SDL_Event &e) {
         case SDLK_UP:
         case SDLK_KP_8:
             if (direction != 1) direction = 0;
-            pause = false;
+            paused = false;
             break;
         case SDLK_DOWN:
             if (direction != 0) direction = 1;
-            pause = false;
+            paused = false;
             break;
         case SDLK_LEFT:
             if (direction != 3) direction = 2;
-            pause = false;
+            paused = false;
             break;
         case SDLK_RIGHT:
             if (direction != 2) direction = 3;
-            pause = false;
+            paused = false;
             break;
         case SDLK_SPACE:
-            pause = !pause;
+            paused = !paused;
             break;
         case SDLK_0:
             quit = true;
@@ -73,34 +137,40 @@ void Snake::handleInput(SDL_Event &e) {
 }
 
 void Snake::move() {
-    SDL_Rect newHead = body.front();
+    int x = BoardGeometry::x(body.front()), y = BoardGeometry::y(body.front());
 
     switch (direction) {
-    case 0: newHead.y -= TILE_SIZE; break; // Up
-    case 1: newHead.y += TILE_SIZE; break; // Down
-    case 2: newHead.x -= TILE_SIZE; break; // Left
-    case 3: newHead.x += TILE_SIZE; break; // Right
+    case 0: y--; break; // Up
+    case 1: y++; break; // Down
+    case 2: x--; break; // Left
+    case 3: x++; break; // Right
     }
 
+    // The frame is wall, so only a snake placed by hand gets this far.
+    if (!BoardGeometry::inside(x, y)) {
+        gameOver = true;
+        return;
+    }
+    Tile newHead = BoardGeometry::index(x, y);
     body.insert(body.begin(), newHead);
 
-    if (newHead.x == food.x && newHead.y == food.y) {
+    if (newHead == food) {
         score += 1;
         spawnFood();
     } else {
         body.pop_back();
     }
 
-    if (bonusFoodActive && newHead.x < bonusFood.x + bonusFood.w && newHead.x + newHead.w > bonusFood.x &&
-        newHead.y < bonusFood.y + bonusFood.h && newHead.y + newHead.h > bonusFood.y) {
+    if (bonusFoodActive && newHead == bonusFood) {
         score += 10;
-        body.push_back(SDL_Rect{-20, -20, TILE_SIZE, TILE_SIZE});
+        body.push_back(body.back()); // unfolds from the tail as the snake moves
         bonusFoodActive = false;
+        timers.cancel(bonusTimer);
     }
 
-    if (bonusFoodActive && SDL_GetTicks() > bonusFoodTimer) {
-        bonusFoodActive = false;
-    }
+    timers.advance([&](GameEvent e) {
+        if (e == GameEvent::BONUS_EXPIRES) bonusFoodActive = false;
+    });
 
     if (checkCollision()) {
         gameOver = true;
@@ -108,103 +178,310 @@ void Snake::move() {
 }
 
 void Snake::render(SDL_Renderer *renderer) {
+    SDL_Rect r;
     SDL_SetRenderDrawColor(renderer, 173, 216, 230, 255);
-    for (int i = 1; i < body.size(); ++i)
-        SDL_RenderFillRect(renderer, &body[i]);
+    for (size_t i = 1; i < body.size(); ++i) {
+        r = tileRect(body[i]);
+        SDL_RenderFillRect(renderer, &r);
+    }
 
     SDL_SetRenderDrawColor(renderer, 80, 120, 200, 255);
-    SDL_RenderFillRect(renderer, &body[0]);
+    r = tileRect(body[0]);
+    SDL_RenderFillRect(renderer, &r);
 
     SDL_SetRenderDrawColor(renderer, 255, 178, 102, 255);
-    SDL_RenderFillRect(renderer, &food);
+    r = tileRect(food);
+    SDL_RenderFillRect(renderer, &r);
 
     if (bonusFoodActive) {
         SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-        SDL_RenderFillRect(renderer, &bonusFood);
+        r = tileRect(bonusFood);
+        SDL_RenderFillRect(renderer, &r);
     }
 
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_Rect walls[] = {
-        {SCREEN_WIDTH / 3 + 200, SCREEN_HEIGHT / 3 - 100, 20, 340},
-        {SCREEN_HEIGHT / 3 + 160, SCREEN_WIDTH / 3 - 60, 340, 20},
-        {100, 150, 20, 380},
-        {1060 - 100, 150, 20, 380},
-        {0, 720 - 4 * TILE_SIZE, SCREEN_WIDTH, TILE_SIZE * 4},
-        {0, 0, 20, SCREEN_HEIGHT},
-        {1060, 0, 20, SCREEN_HEIGHT},
-        {0, 0, SCREEN_WIDTH, 20},
-    };
-    for (auto &wall : walls) SDL_RenderFillRect(renderer, &wall);
+    for (auto &wall : WALLS) {
+        r = tilesToPixels(wall, TILE_SIZE);
+        SDL_RenderFillRect(renderer, &r);
+    }
 }
 
-bool Snake::checkCollision() {
-    SDL_Rect head = body.front();
-    for (auto it = body.begin() + 1; it != body.end(); ++it)
-        if (head.x == it->x && head.y == it->y) return true;
+// The same picture drawn by the software rasterizer, from tiles or, in
+// replay2video and clips, from the pixel rectangles of a replay.
+template <class Cell>
+void drawBoard(SoftFramebuffer &fb, const std::vector<Cell> &body, const Cell &food, const Cell *bonusFood) {
+    uint32_t segment = fb.map(173, 216, 230);
+    for (size_t i = 1; i < body.size(); ++i)
+        fb.fillRect(tileRect(body[i]), segment);
+
+    if (!body.empty()) fb.fillRect(tileRect(body[0]), fb.map(80, 120, 200));
+    fb.fillRect(tileRect(food), fb.map(255, 178, 102));
+    if (bonusFood) fb.fillRect(tileRect(*bonusFood), fb.map(0, 255, 0));
+
+    uint32_t wall = fb.map(0, 0, 0);
+    for (auto &w : WALLS) fb.fillRect(tilesToPixels(w, TILE_SIZE), wall);
+}
+
+void Snake::render(SoftFramebuffer &fb) {
+    drawBoard(fb, body, food, bonusFoodActive ? &bonusFood : nullptr);
+}
 
-    if (head.y < 0 || head.y >= SCREEN_HEIGHT - 4 * TILE_SIZE ||
-        head.x < TILE_SIZE || head.x >= SCREEN_WIDTH - TILE_SIZE) return true;
+// Textured skin for --textured and --theme DIR. Sprites are drawn for a
+// snake heading right: the head faces right with its neck on the left,
+// straight segments run left to right, the tail has the body on its right
+// and a corner joins the left and bottom edges. Quarter turns cover the
+// other directions.
+enum ThemeSprite { SPRITE_HEAD, SPRITE_STRAIGHT, SPRITE_CORNER, SPRITE_TAIL, SPRITE_FOOD, SPRITE_BONUS, SPRITE_WALL, SPRITE_COUNT };
+const char *const THEME_FILES[SPRITE_COUNT] = {"head", "straight", "corner", "tail", "food", "bonus", "wall"};
 
-    SDL_Rect walls[] = {
-        {SCREEN_WIDTH / 3 + 200, SCREEN_HEIGHT / 3 - 100, 20, 340},
-        {SCREEN_HEIGHT / 3 + 160, SCREEN_WIDTH / 3 - 60, 340, 20},
-        {100, 150, 20, 380},
-        {1060 - 100, 150, 20, 380},
+// The built-in look: the flat colours of the plain renderer with some shape.
+void drawBuiltinSprite(SoftFramebuffer &fb, ThemeSprite sprite) {
+    const int t = TILE_SIZE, c = t / 2;
+    fb.clear(fb.map(0, 0, 0, 0));
+    auto disc = [&](int radius, uint32_t value) {
+        for (int y = 0; y < t; ++y) {
+            int dy = 2 * y + 1 - t, half = 0;
+            while ((2 * half + 1) * (2 * half + 1) + dy * dy <= 4 * radius * radius) ++half;
+            fb.fillRect({c - half, y, 2 * half, 1}, value);
+        }
     };
-    for (auto &wall : walls)
-        if (head.x < wall.x + wall.w && head.x + head.w > wall.x &&
-            head.y < wall.y + wall.h && head.y + head.h > wall.y)
-            return true;
+    switch (sprite) {
+    case SPRITE_HEAD:
+        fb.fillRect({0, 1, t - 1, t - 2}, fb.map(80, 120, 200));
+        fb.fillRect({t - 8, 4, 4, 4}, fb.map(255, 255, 255));
+        fb.fillRect({t - 8, t - 8, 4, 4}, fb.map(255, 255, 255));
+        fb.fillRect({t - 6, 5, 2, 2}, fb.map(0, 0, 0));
+        fb.fillRect({t - 6, t - 7, 2, 2}, fb.map(0, 0, 0));
+        break;
+    case SPRITE_STRAIGHT:
+        fb.fillRect({0, 2, t, t - 4}, fb.map(173, 216, 230));
+        fb.fillRect({0, 2, t, 2}, fb.map(130, 180, 205));
+        fb.fillRect({0, t - 4, t, 2}, fb.map(130, 180, 205));
+        break;
+    case SPRITE_CORNER:
+        fb.fillRect({0, 2, t - 2, t - 2}, fb.map(173, 216, 230));
+        fb.fillRect({0, 2, t - 2, 2}, fb.map(130, 180, 205));
+        fb.fillRect({t - 4, 2, 2, t - 2}, fb.map(130, 180, 205));
+        break;
+    case SPRITE_TAIL:
+        for (int x = 0; x < t; ++x) {
+            int h = 4 + (t - 8) * x / (t - 1);
+            fb.fillRect({x, (t - h) / 2, 1, h}, fb.map(173, 216, 230));
+        }
+        break;
+    case SPRITE_FOOD:
+        disc(c - 2, fb.map(255, 178, 102));
+        fb.fillRect({c - 3, c - 5, 3, 3}, fb.map(255, 230, 190));
+        break;
+    case SPRITE_BONUS:
+        disc(c - 1, fb.map(0, 200, 0));
+        disc(c - 4, fb.map(0, 255, 0));
+        break;
+    case SPRITE_WALL:
+        fb.clear(fb.map(0, 0, 0));
+        fb.fillRect({0, c - 1, t, 1}, fb.map(60, 60, 60));
+        fb.fillRect({0, t - 1, t, 1}, fb.map(60, 60, 60));
+        fb.fillRect({c, 0, 1, c - 1}, fb.map(60, 60, 60));
+        fb.fillRect({0, c, 1, c - 1}, fb.map(60, 60, 60));
+        break;
+    default:
+        break;
+    }
+}
+
+struct Theme {
+    SpriteAtlas atlas;
+    int sprites[SPRITE_COUNT] = {};
+
+    // Loads DIR/head.png, DIR/straight.png and so on; sprites missing from
+    // dir (or all of them, when dir is null) are the built-in ones. Returns
+    // false if the atlas cannot be made.
+    bool load(SDL_Renderer *renderer, const char *dir) { return prepare(dir) && atlas.upload(renderer); }
+
+    // load() without the texture upload, for a loading thread. SDL_image is
+    // only started when there is a directory to read. On failure the reason
+    // is in SDL_GetError() on the calling thread, as SDL keeps one per thread.
+    bool prepare(const char *dir) {
+        if (dir) IMG_Init(IMG_INIT_PNG);
+        SoftFramebuffer tile(TILE_SIZE, TILE_SIZE, SoftFramebuffer::RGBA32);
+        for (int i = 0; i < SPRITE_COUNT; ++i) {
+            SDL_Surface *image = dir ? IMG_Load((std::string(dir) + "/" + THEME_FILES[i] + ".png").c_str()) : nullptr;
+            sprites[i] = image ? atlas.add(image) : -1;
+            if (image) SDL_FreeSurface(image);
+            if (sprites[i] < 0) {
+                drawBuiltinSprite(tile, ThemeSprite(i));
+                sprites[i] = atlas.add(tile.data(), TILE_SIZE, TILE_SIZE, tile.pitch());
+            }
+        }
+        if (atlas.pack()) return true;
+        SDL_SetError("the sprites do not fit in the largest atlas");
+        return false;
+    }
+};
+
+// Side of b as seen from a: 0 up, 1 right, 2 down, 3 left, or -1 when they
+// are not neighbours (the same cell, or a segment parked off the board).
+int sideOf(const SDL_Rect &a, const SDL_Rect &b) {
+    int dx = b.x - a.x, dy = b.y - a.y;
+    if (dy == 0 && (dx == TILE_SIZE || dx == -TILE_SIZE)) return dx > 0 ? 1 : 3;
+    if (dx == 0 && (dy == TILE_SIZE || dy == -TILE_SIZE)) return dy > 0 ? 2 : 0;
+    return -1;
+}
+
+// Queues the whole picture, walls included, so it takes a single draw call
+// however long the snake is. Segments are straight, corner or tail pieces
+// depending on where their neighbours are.
+template <class Cell>
+void drawBoard(SpriteBatch &batch, const Theme &theme, const std::vector<Cell> &body, const Cell &food,
+               const Cell *bonusFood) {
+    const int *sprite = theme.sprites;
+    for (size_t i = body.size(); i-- > 1;) {
+        const SDL_Rect &cell = tileRect(body[i]);
+        int toHead = sideOf(cell, tileRect(body[i - 1]));
+        if (i + 1 == body.size()) {
+            batch.add(sprite[SPRITE_TAIL], cell, toHead < 0 ? 0 : (toHead - 1) & 3);
+            continue;
+        }
+        int toTail = sideOf(cell, tileRect(body[i + 1]));
+        if (toHead < 0 && toTail < 0) toHead = 3, toTail = 1;
+        else if (toHead < 0) toHead = (toTail + 2) & 3;
+        else if (toTail < 0) toTail = (toHead + 2) & 3;
 
-    return false;
+        if (((toHead - toTail) & 3) == 2) {
+            batch.add(sprite[SPRITE_STRAIGHT], cell, toHead & 1 ? 0 : 1);
+        } else {
+            int first = ((toHead + 1) & 3) == toTail ? toHead : toTail; // clockwise first of the two sides
+            batch.add(sprite[SPRITE_CORNER], cell, (first - 2) & 3);
+        }
+    }
+    if (!body.empty()) {
+        int neck = body.size() > 1 ? sideOf(tileRect(body[0]), tileRect(body[1])) : -1;
+        batch.add(sprite[SPRITE_HEAD], tileRect(body[0]), neck < 0 ? 0 : (neck + 1) & 3);
+    }
+
+    batch.add(sprite[SPRITE_FOOD], tileRect(food));
+    if (bonusFood) batch.add(sprite[SPRITE_BONUS], tileRect(*bonusFood));
+
+    for (const SDL_Rect &w : WALLS)
+        for (int y = w.y; y < w.y + w.h; ++y)
+            for (int x = w.x; x < w.x + w.w; ++x) batch.add(sprite[SPRITE_WALL], tileRect(BoardGeometry::index(x, y)));
+}
+
+void Snake::render(SpriteBatch &batch, const Theme &theme) {
+    drawBoard(batch, theme, body, food, bonusFoodActive ? &bonusFood : nullptr);
+}
+
+void Snake::capture(ReplayState &state) const {
+    state.body.resize(body.size());
+    for (size_t i = 0; i < body.size(); ++i) state.body[i] = tileRect(body[i]);
+    state.food = tileRect(food);
+    state.bonusActive = bonusFoodActive;
+    state.bonusFood = tileRect(bonusFood);
+    state.score = score;
+}
+
+bool Snake::checkCollision() {
+    Tile head = body.front();
+    for (auto it = body.begin() + 1; it != body.end(); ++it)
+        if (*it == head) return true;
+    return WALL_TILES[head];
 }
 
 void Snake::spawnFood() {
     static std::random_device rd;
     static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> disX(20 / TILE_SIZE, 1060 / TILE_SIZE - 1);
-    static std::uniform_int_distribution<> disY(60 / TILE_SIZE, 620 / TILE_SIZE - 1);
+    static std::uniform_int_distribution<> disX(1, BoardGeometry::cols - 2);
+    static std::uniform_int_distribution<> disY(3, PLAY_ROWS - 2);
+
+    auto randomFreeCell = [this]() {
+        auto occupied = [this](Tile t) { return std::find(body.begin(), body.end(), t) != body.end(); };
 
-    SDL_Point foodPosition;
-    do {
-        foodPosition.x = disX(gen) * TILE_SIZE;
-        foodPosition.y = disY(gen) * TILE_SIZE;
-    } while (std::any_of(body.begin(), body.end(), [foodPosition](const SDL_Rect &segment) {
-        return foodPosition.x == segment.x && foodPosition.y == segment.y;
-    }));
+        Tile t;
+        for (int attempt = 0; attempt < 16; ++attempt) {
+            t = BoardGeometry::index(disX(gen), disY(gen));
+            if (!occupied(t)) return t;
+        }
 
-    food = {foodPosition.x, foodPosition.y, TILE_SIZE, TILE_SIZE};
+        // The board is crowded and random probing keeps hitting the snake, so
+        // list the free cells in the frame arena and pick one of those.
+        BoardGeometry::Grid<bool> taken{};
+        for (Tile segment : body) taken[segment] = true;
+        std::pmr::vector<Tile> freeCells(&frameArena());
+        freeCells.reserve(BoardGeometry::cells);
+        for (int y = disY.min(); y <= disY.max(); ++y)
+            for (int x = disX.min(); x <= disX.max(); ++x)
+                if (!taken[BoardGeometry::index(x, y)]) freeCells.push_back(BoardGeometry::index(x, y));
+        if (freeCells.empty()) return t; // nowhere left; keep the last guess
+
+        std::uniform_int_distribution<size_t> pick(0, freeCells.size() - 1);
+        return freeCells[pick(gen)];
+    };
+
+    food = randomFreeCell();
 
     if (score % 5 == 0) {
         bonusFoodActive = true;
-        bonusFoodTimer = SDL_GetTicks() + 7000;
-        SDL_Point bonusFoodPosition;
-        do {
-            bonusFoodPosition.x = disX(gen) * TILE_SIZE;
-            bonusFoodPosition.y = disY(gen) * TILE_SIZE;
-        } while (std::any_of(body.begin(), body.end(), [bonusFoodPosition](const SDL_Rect &segment) {
-            return bonusFoodPosition.x == segment.x && bonusFoodPosition.y == segment.y;
-        }));
-        bonusFood = {bonusFoodPosition.x, bonusFoodPosition.y, TILE_SIZE, TILE_SIZE};
+        bonusFood = randomFreeCell();
+        timers.cancel(bonusTimer);
+        bonusTimer = timers.after(BONUS_MOVES, GameEvent::BONUS_EXPIRES);
     }
 }
 
-void renderScore(SDL_Renderer *renderer, TTF_Font *font, int score) {
-    SDL_Color fontColor = {255, 255, 102, 255};
-    SDL_Surface *surface = TTF_RenderText_Solid(font, ("Score: " + std::to_string(score)).c_str(), fontColor);
-    SDL_Texture *text = SDL_CreateTextureFromSurface(renderer, surface);
-    SDL_Rect textRect = {800, 720 - 4 * TILE_SIZE, 7 * TILE_SIZE, 4 * TILE_SIZE};
-    SDL_RenderCopy(renderer, text, nullptr, &textRect);
-    SDL_DestroyTexture(text);
-    SDL_FreeSurface(surface);
+// Where the score goes, in the HUD strip.
+const SDL_Rect SCORE_RECT = {40 * TILE_SIZE, PLAY_ROWS * TILE_SIZE, 7 * TILE_SIZE, HUD_ROWS * TILE_SIZE};
+
+// The score texture is only rebuilt when the score changes, so drawing it
+// every frame does not allocate.
+SDL_Texture *scoreText = nullptr;
+int scoreTextValue = -1;
+
+void renderScore(SDL_Renderer *renderer, TextRenderer &text, int score) {
+    if (!scoreText || score != scoreTextValue) {
+        if (scoreText) SDL_DestroyTexture(scoreText);
+        char label[32];
+        std::snprintf(label, sizeof label, "Score: %d", score);
+        SDL_Color fontColor = {255, 255, 102, 255};
+        SDL_Surface *surface = text.renderSolid(label, fontColor);
+        scoreText = surface ? SDL_CreateTextureFromSurface(renderer, surface) : nullptr;
+        SDL_FreeSurface(surface);
+        scoreTextValue = score;
+    }
+
+    SDL_RenderCopy(renderer, scoreText, nullptr, &SCORE_RECT);
 }
 
-void displayGameOver(SDL_Renderer *renderer, TTF_Font *font, int finalScore) {
+// Software-rasterizer version; keeps the rendered text surface instead.
+// Each thread drawing scores needs its own label (and font).
+struct ScoreLabel {
+    SDL_Surface *surface = nullptr;
+    int value = -1;
+
+    ~ScoreLabel() {
+        if (surface) SDL_FreeSurface(surface);
+    }
+};
+ScoreLabel scoreLabel;
+
+void renderScore(SoftFramebuffer &fb, TextRenderer &textRenderer, int score, ScoreLabel &label = scoreLabel) {
+    if (!label.surface || score != label.value) {
+        if (label.surface) SDL_FreeSurface(label.surface);
+        char text[32];
+        std::snprintf(text, sizeof text, "Score: %d", score);
+        label.surface = textRenderer.renderSolid(text, SDL_Color{255, 255, 255, 255});
+        label.value = score;
+    }
+
+    fb.drawMask(label.surface, SCORE_RECT, fb.map(255, 255, 102));
+}
+
+void displayGameOver(SDL_Renderer *renderer, TextRenderer &textRenderer, int finalScore) {
     SDL_SetRenderDrawColor(renderer, 204, 200, 153, 0);
     SDL_RenderClear(renderer);
 
+    char label[48];
+    std::snprintf(label, sizeof label, "Game Over! Final Score: %d", finalScore);
     SDL_Color textColor = {255, 255, 255, 255};
-    SDL_Surface *surface = TTF_RenderText_Solid(font, ("Game Over! Final Score: " + std::to_string(finalScore)).c_str(), textColor);
+    SDL_Surface *surface = textRenderer.renderSolid(label, textColor);
     SDL_Texture *text = SDL_CreateTextureFromSurface(renderer, surface);
     SDL_Rect textRect = {SCREEN_WIDTH / 4, SCREEN_HEIGHT / 3, SCREEN_WIDTH / 2, SCREEN_HEIGHT / 5};
     SDL_RenderCopy(renderer, text, nullptr, &textRect);
@@ -213,12 +490,206 @@ void displayGameOver(SDL_Renderer *renderer, TTF_Font *font, int finalScore) {
 
     SDL_RenderPresent(renderer);
     SDL_Delay(3000);
-    exit(0);
 }
 
+// Length of the clips saved with F9/F10.
+const int CLIP_SECONDS = 10;
+
+#ifndef SNAKE_NO_MAIN
+// PREFIX_YYYYmmdd_HHMMSS_mmm.EXTENSION in the working directory. If that
+// name was already handed out, or a file has it, -2, -3 and so on are added,
+// so two saves in one millisecond, including one still queued for its writer,
+// never land on the same file.
+std::string timestampedPath(const char *prefix, const char *extension) {
+    static std::set<std::string> given;
+    auto now = std::chrono::system_clock::now();
+    std::time_t seconds = std::chrono::system_clock::to_time_t(now);
+    long long millis = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+    char stamp[64];
+    size_t n = std::strftime(stamp, sizeof stamp, "_%Y%m%d_%H%M%S", std::localtime(&seconds));
+    std::snprintf(stamp + n, sizeof stamp - n, "_%03lld", millis);
+
+    std::string base = prefix + std::string(stamp);
+    for (int copy = 1;; ++copy) {
+        std::string path = base + (copy > 1 ? "-" + std::to_string(copy) : "") + "." + extension;
+        if (given.count(path)) continue;
+        if (std::FILE *existing = std::fopen(path.c_str(), "rb")) {
+            std::fclose(existing);
+            continue;
+        }
+        given.insert(path);
+        return path;
+    }
+}
+
+// --software draws every frame with softraster.h and only hands the finished
+// frame to SDL, for machines without a GPU. --record FILE saves a replay for
+// replay2video. The last CLIP_SECONDS are always kept; F9 saves them as a GIF
+// and F10 as an APNG. F12 saves a PNG screenshot, Shift+F12 a BMP.
+// --textured draws the built-in sprites and --theme DIR loads them from DIR
+// (see Theme); neither applies to --software. Text comes from the glyphs
+// baked into font_arial28.h; --ttf-text loads arial.ttf at startup and draws
+// with it instead, as the game used to. --startup-stats prints how long each
+// step before the first frame took.
+//
+// Only video is initialized up front. SDL_ttf starts when a font is opened,
+// SDL_image when a theme directory is read, and the theme and the screenshot
+// buffers are prepared on other threads while the first frames are shown.
 int main(int argc, char *argv[]) {
+    bool startupStats = false;
+    for (int i = 1; i < argc; ++i) startupStats |= std::strcmp(argv[i], "--startup-stats") == 0;
+    StartupTimeline startup(startupStats);
+#ifdef SNAKE_ALLOC_TRACK
+    trackSDLAllocations();
+#endif
+    bool software = false;
+    bool textured = false, ttfText = false;
+    const char *recordPath = nullptr, *themeDir = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--software") == 0) software = true;
+        else if (std::strcmp(argv[i], "--textured") == 0) textured = true;
+        else if (std::strcmp(argv[i], "--theme") == 0 && i + 1 < argc) textured = true, themeDir = argv[++i];
+        else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) recordPath = argv[++i];
+        else if (std::strcmp(argv[i], "--ttf-text") == 0) ttfText = true;
+    }
+    startup.mark("arguments");
+
+    // Until the theme is ready the flat colours are drawn. It is released
+    // before the renderer, which owns the atlas texture.
+    std::unique_ptr<Theme> theme;
+    std::unique_ptr<SpriteBatch> sprites;
+    std::future<std::string> themeReady; // empty when the theme is ready, otherwise why it is not
+    if (textured && !software) {
+        theme.reset(new Theme);
+        themeReady = std::async(std::launch::async, [&theme, themeDir, &startup] {
+            Uint64 from = SDL_GetPerformanceCounter();
+            std::string error = theme->prepare(themeDir) ? "" : SDL_GetError(); // this thread's error
+            startup.markBackground("theme", from);
+            return error;
+        });
+        startup.mark("theme loader thread");
+    }
+
     SDL_Init(SDL_INIT_VIDEO);
-    TTF_Init();
-    IMG_Init(IMG_INIT_PNG);
+    startup.mark("SDL_Init(VIDEO)");
+    SDL_Window *window = SDL_CreateWindow("Snake Game", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
+    startup.mark("window");
+    SDL_Renderer *renderer = SDL_CreateRenderer(window, -1, software ? SDL_RENDERER_SOFTWARE : SDL_RENDERER_ACCELERATED);
+    startup.mark("renderer");
+
+    TextRenderer text(bakedfonts::arial28, "arial.ttf"); // the TTF only for text that was not baked
+    if (ttfText) {
+        text.useBaked(false);
+        text.openFallback();
+        startup.mark("font (arial.ttf)");
+    }
+
+    SoftFramebuffer frame(software ? SCREEN_WIDTH : 0, software ? SCREEN_HEIGHT : 0, SoftFramebuffer::RGBA32);
+    SDL_Texture *frameTexture = software ? SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING,
+                                                             SCREEN_WIDTH, SCREEN_HEIGHT) : nullptr;
+
+    Snake snake;
+    SDL_Event e;
+    unsigned long long tick = 0;
+
+    ReplayWriter replay;
+    ReplayState replayState;
+    if (recordPath && !replay.open(recordPath, SCREEN_WIDTH, SCREEN_HEIGHT, TILE_SIZE, 10))
+        std::cerr << "Cannot write replay " << recordPath << std::endl;
+
+    // Clips are drawn on the exporter's thread, with a font and label of its own.
+    ClipRecorder clips(SCREEN_WIDTH, SCREEN_HEIGHT, TILE_SIZE, 10, CLIP_SECONDS);
+    TextRenderer clipText(bakedfonts::arial28); // baked only: no font opening off the main thread
+    ScoreLabel clipLabel;
+    ClipExporter exporter([&](SoftFramebuffer &fb, const ReplayState &s) {
+        fb.clear(fb.map(204, 200, 153));
+        drawBoard(fb, s.body, s.food, s.bonusActive ? &s.bonusFood : nullptr);
+        renderScore(fb, clipText, s.score, clipLabel);
+    });
+
+    // Taken at the end of the frame in which F12 was pressed.
+    ScreenshotWriter screenshots(SCREEN_WIDTH, SCREEN_HEIGHT);
+    int screenshotFormat = -1;
+    startup.mark("game state and workers");
 
-    SDL_Window *window = SDL_CreateWindow("Snake Game", SDL_WINDOW
+    while (!quit) {
+        while (SDL_PollEvent(&e)) {
+            if (e.type == SDL_QUIT) quit = true;
+            if (e.type == SDL_KEYDOWN && (e.key.keysym.sym == SDLK_F9 || e.key.keysym.sym == SDLK_F10)) {
+                auto format = e.key.keysym.sym == SDLK_F9 ? AnimationEncoder::GIF : AnimationEncoder::APNG;
+                std::string path = timestampedPath("clip", format == AnimationEncoder::GIF ? "gif" : "png");
+                if (!exporter.submit(clips.snapshot(), clips.framesWanted(), format, path))
+                    std::cerr << "Still saving the previous clip" << std::endl;
+            }
+            if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_F12)
+                screenshotFormat = e.key.keysym.mod & KMOD_SHIFT ? ScreenshotWriter::BMP : ScreenshotWriter::PNG;
+            snake.handleInput(e);
+        }
+
+        if (themeReady.valid() && themeReady.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            std::string error = themeReady.get();
+            if (!error.empty()) std::cerr << "Cannot build the sprite atlas: " << error << std::endl;
+            else if (theme->atlas.upload(renderer)) sprites.reset(new SpriteBatch(theme->atlas));
+            else std::cerr << "Cannot upload the sprite atlas: " << SDL_GetError() << std::endl;
+        }
+
+        if (!paused) snake.move();
+        ALLOC_REPORT("move", tick);
+        snake.capture(replayState);
+        clips.frame(replayState);
+        replay.frame(replayState); // before game over, so the crash is in the replay
+        if (gameOver) {
+            // Out through the shutdown below, so a clip being saved is finished.
+            displayGameOver(renderer, text, score);
+            break;
+        }
+
+        if (software) {
+            frame.clear(frame.map(204, 200, 153));
+            snake.render(frame);
+            renderScore(frame, text, score);
+            SDL_UpdateTexture(frameTexture, nullptr, frame.data(), frame.pitch());
+            SDL_RenderCopy(renderer, frameTexture, nullptr, nullptr);
+        } else {
+            SDL_SetRenderDrawColor(renderer, 204, 200, 153, 255);
+            SDL_RenderClear(renderer);
+            if (sprites) {
+                snake.render(*sprites, *theme);
+                sprites->flush(renderer);
+            } else {
+                snake.render(renderer);
+            }
+            renderScore(renderer, text, score);
+        }
+        if (screenshotFormat >= 0) {
+            auto format = static_cast<ScreenshotWriter::Format>(screenshotFormat);
+            std::string path = timestampedPath("screenshot", format == ScreenshotWriter::PNG ? "png" : "bmp");
+            if (!screenshots.capture(renderer, format, path)) std::cerr << "Screenshot dropped" << std::endl;
+            screenshotFormat = -1;
+        }
+        SDL_RenderPresent(renderer);
+        if (tick == 0) {
+            startup.mark("first frame");
+            startup.print();
+        }
+        ALLOC_REPORT("render", tick);
+        frameArena().reset();
+        tick++;
+        SDL_Delay(100);
+    }
+
+    if (themeReady.valid()) themeReady.wait();
+    screenshots.stop();
+    exporter.stop();
+    if (frameTexture) SDL_DestroyTexture(frameTexture);
+    sprites.reset();
+    theme.reset();
+    text.close();
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    IMG_Quit();
+    if (TTF_WasInit()) TTF_Quit();
+    SDL_Quit();
+    return 0;
+}
+#endif
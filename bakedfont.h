@@ -0,0 +1,127 @@
+// Text drawn from glyphs baked into the program by fontbake, so the game can
+// show its score without loading a TrueType font at startup.
+//
+// A baked font is a strip of 1-bit glyph images plus their placement, made
+// from a TTF at one size (see fontbake.cpp and font_arial28.h). TextRenderer
+// turns a string into the same kind of surface TTF_RenderText_Solid returns,
+// and falls back to the TTF itself, opened on first use, for text with
+// characters that were not baked.
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+struct BakedGlyph {
+    char ch;
+    uint16_t x;     // left edge in the strip
+    uint8_t w, h;   // ink size; 0 for blank glyphs such as the space
+    int16_t dx, dy; // ink position relative to the pen and the top of the line
+    uint16_t advance;
+};
+
+struct BakedFontData {
+    int size, height, ascent;
+    int stripWidth, stripHeight;
+    const uint8_t *bits; // row-major, (stripWidth + 7) / 8 bytes a row, bit 0 first
+    const BakedGlyph *glyphs;
+    int glyphCount;
+};
+
+class TextRenderer {
+public:
+    // fallbackPath is the TTF the font was baked from, or nullptr for baked
+    // glyphs only.
+    explicit TextRenderer(const BakedFontData &baked, const char *fallbackPath = nullptr)
+        : baked(baked), fallbackPath(fallbackPath) {
+        std::memset(index, -1, sizeof index);
+        for (int i = 0; i < baked.glyphCount; ++i)
+            if (static_cast<unsigned char>(baked.glyphs[i].ch) < 128) index[static_cast<unsigned char>(baked.glyphs[i].ch)] = i;
+    }
+
+    ~TextRenderer() { close(); }
+
+    TextRenderer(const TextRenderer&) = delete;
+    TextRenderer& operator=(const TextRenderer&) = delete;
+
+    // Opens the fallback font now rather than on first use. Opening fonts is
+    // not thread-safe, so threads sharing SDL_ttf should do this up front.
+    bool openFallback() {
+        if (fallback || !fallbackPath) return fallback != nullptr;
+        if (!TTF_WasInit()) TTF_Init(); // SDL_ttf is only started when a font is needed
+        fallback = TTF_OpenFont(fallbackPath, baked.size);
+        return fallback != nullptr;
+    }
+
+    // Closes the fallback font, which must happen before TTF_Quit(). It is
+    // opened again if needed.
+    void close() {
+        if (fallback) TTF_CloseFont(fallback);
+        fallback = nullptr;
+    }
+
+    // Draws everything with the fallback font, as before fonts were baked.
+    void useBaked(bool on) { bakedEnabled = on; }
+
+    // Like TTF_RenderText_Solid: an 8-bit surface whose index 0 is the
+    // transparent background and index 1 the colour. nullptr if the text
+    // cannot be drawn.
+    SDL_Surface *renderSolid(const char *text, SDL_Color color) {
+        if (bakedEnabled && covers(text)) return renderBaked(text, color);
+        if (!openFallback()) return nullptr;
+        return TTF_RenderText_Solid(fallback, text, color);
+    }
+
+    bool covers(const char *text) const {
+        for (const char *p = text; *p; ++p)
+            if (static_cast<unsigned char>(*p) >= 128 || index[static_cast<unsigned char>(*p)] < 0) return false;
+        return *text != 0;
+    }
+
+private:
+    SDL_Surface *renderBaked(const char *text, SDL_Color color) const {
+        int width = 0, pen = 0;
+        for (const char *p = text; *p; ++p) {
+            const BakedGlyph &g = glyph(*p);
+            if (g.w) width = std::max(width, pen + g.dx + g.w);
+            pen += g.advance;
+        }
+        width = std::max(width, pen);
+
+        SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, width, baked.height, 8, SDL_PIXELFORMAT_INDEX8);
+        if (!surface) return nullptr;
+        const SDL_Color colors[2] = {{0, 0, 0, 0}, color};
+        SDL_SetPaletteColors(surface->format->palette, colors, 0, 2);
+        SDL_SetColorKey(surface, SDL_TRUE, 0);
+
+        const int stripPitch = (baked.stripWidth + 7) / 8;
+        uint8_t *pixels = static_cast<uint8_t *>(surface->pixels);
+        std::memset(pixels, 0, size_t(surface->pitch) * surface->h);
+        pen = 0;
+        for (const char *p = text; *p; ++p) {
+            const BakedGlyph &g = glyph(*p);
+            for (int y = 0; y < g.h; ++y) {
+                int ty = g.dy + y;
+                if (ty < 0 || ty >= surface->h) continue;
+                const uint8_t *bits = baked.bits + size_t(y) * stripPitch;
+                uint8_t *row = pixels + size_t(ty) * surface->pitch;
+                for (int x = 0; x < g.w; ++x) {
+                    int sx = g.x + x, tx = pen + g.dx + x;
+                    if (tx >= 0 && tx < width && (bits[sx >> 3] >> (sx & 7) & 1)) row[tx] = 1;
+                }
+            }
+            pen += g.advance;
+        }
+        return surface;
+    }
+
+    const BakedGlyph &glyph(char c) const { return baked.glyphs[index[static_cast<unsigned char>(c)]]; }
+
+    const BakedFontData &baked;
+    const char *fallbackPath;
+    TTF_Font *fallback = nullptr;
+    bool bakedEnabled = true;
+    int8_t index[128]; // glyph of each ASCII character, or -1
+};
@@ -0,0 +1,173 @@
+// Microbenchmarks for the hot paths in a.cpp and b.cpp, and for the data
+// structures meant to replace them on larger boards.
+//
+//   bench [--json] [--filter NAME] [--lengths 1,16,128] [--min-time SECONDS]
+//         [--perf] [--perf-ticks [N]] [--check-alloc]
+//
+// --json prints one JSON object per line so two runs can be diffed or fed to
+// other tools; otherwise a table is printed.
+//
+// --perf adds hardware counters per op (see perfcount.h), grouped by game
+// phase. --perf-ticks also times N ticks (5000 by default) each on its own,
+// after the usual warm-up, and prints one line per tick, keyed "tick_of"
+// rather than "bench" so tools reading results skip it; the counter reads
+// then add a little overhead to each tick.
+//
+// Every result includes the heap allocations made per op once warmed up.
+// --check-alloc exits with 1 if any benchmark that models steady-state play
+// allocated at all. The frame arena's high-water mark is printed at the end.
+#define SDL_MAIN_HANDLED
+#define ALLOC_TRACK_IMPLEMENTATION
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "bench.h"
+
+static std::vector<int> parseLengths(const char *text) {
+    std::vector<int> lengths;
+    for (const char *p = text; *p;) {
+        lengths.push_back(std::atoi(p));
+        p = std::strchr(p, ',');
+        if (!p) break;
+        ++p;
+    }
+    return lengths;
+}
+
+static double percentile(std::vector<double> sorted, double q) {
+    std::sort(sorted.begin(), sorted.end());
+    size_t i = static_cast<size_t>(q * (sorted.size() - 1) + 0.5);
+    return sorted[i];
+}
+
+static void printResult(const BenchResult &r, const BenchContext &ctx, bool json) {
+    double n = static_cast<double>(ctx.iterations);
+    const PerfSample &c = ctx.perfTotal;
+
+    if (json) {
+        std::printf("{\"bench\":\"%s\",\"phase\":\"%s\",\"board_w\":%d,\"board_h\":%d,\"length\":%d,"
+                    "\"iterations\":%lld,\"ns_per_op\":%.2f,\"p50_ns\":%.2f,\"p99_ns\":%.2f,"
+                    "\"ops_per_sec\":%.1f,\"allocs_per_op\":%.4f",
+                    r.name.c_str(), r.phase, r.boardW, r.boardH, r.length, r.iterations, r.nsPerOp, r.p50Ns, r.p99Ns,
+                    1e9 / r.nsPerOp, ctx.allocs / n);
+        for (const auto &extra : ctx.extras) std::printf(",\"%s\":%.0f", extra.first, extra.second);
+        if (ctx.perf)
+            std::printf(",\"cycles_per_op\":%.2f,\"instructions_per_op\":%.2f,\"cache_misses_per_op\":%.4f,"
+                        "\"branch_misses_per_op\":%.4f",
+                        c.cycles / n, c.instructions / n, c.cacheMisses / n, c.branchMisses / n);
+        std::printf("}\n");
+
+        for (size_t i = 0; i < ctx.perfSamples.size(); ++i) {
+            const PerfSample &t = ctx.perfSamples[i];
+            std::printf("{\"tick_of\":\"%s\",\"phase\":\"%s\",\"length\":%d,\"tick\":%zu,\"ns\":%.1f,"
+                        "\"cycles\":%llu,\"instructions\":%llu,\"cache_misses\":%llu,\"branch_misses\":%llu}\n",
+                        r.name.c_str(), r.phase, r.length, i, ctx.samples[i], (unsigned long long)t.cycles,
+                        (unsigned long long)t.instructions, (unsigned long long)t.cacheMisses,
+                        (unsigned long long)t.branchMisses);
+        }
+    } else {
+        std::printf("%-18s %-9s %4dx%-4d len %-7d %12.1f ns/op  p50 %10.1f  p99 %10.1f  %6.3f allocs", r.name.c_str(),
+                    r.phase, r.boardW, r.boardH, r.length, r.nsPerOp, r.p50Ns, r.p99Ns, ctx.allocs / n);
+        for (const auto &extra : ctx.extras) std::printf("  %s %.0f", extra.first, extra.second);
+        if (ctx.perf)
+            std::printf("  %9.1f cyc  ipc %4.2f  %7.3f llc-miss  %7.3f br-miss", c.cycles / n,
+                        c.cycles ? double(c.instructions) / c.cycles : 0.0, c.cacheMisses / n, c.branchMisses / n);
+        std::printf("\n");
+    }
+    std::fflush(stdout);
+}
+
+int main(int argc, char *argv[]) {
+    bool json = false;
+    std::string filter;
+    std::vector<int> lengths = {1, 16, 128, 512, 65536, 1048576};
+    double minTime = 0.2;
+    bool perf = false, checkAlloc = false;
+    long long perTicks = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--json")) {
+            json = true;
+        } else if (!std::strcmp(argv[i], "--perf")) {
+            perf = true;
+        } else if (!std::strcmp(argv[i], "--perf-ticks")) {
+            perf = true;
+            perTicks = 5000;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0])))
+                perTicks = std::max(1LL, std::atoll(argv[++i]));
+        } else if (!std::strcmp(argv[i], "--check-alloc")) {
+            checkAlloc = true;
+        } else if (!std::strcmp(argv[i], "--filter") && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (!std::strcmp(argv[i], "--lengths") && i + 1 < argc) {
+            lengths = parseLengths(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--min-time") && i + 1 < argc) {
+            minTime = std::atof(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: %s [--json] [--filter NAME] [--lengths 1,16,128] [--min-time SECONDS]\n"
+                         "       [--perf] [--perf-ticks [N]] [--check-alloc]\n",
+                         argv[0]);
+            return 2;
+        }
+    }
+
+    trackSDLAllocations();
+    useHeadlessVideo();
+
+    PerfCounters counters;
+    if (perf && !counters.available()) {
+        std::fprintf(stderr, "bench: hardware counters unavailable: %s\n", counters.reason());
+        perf = false;
+    }
+
+    std::vector<Benchmark> benchmarks;
+    addGameABenchmarks(benchmarks);
+    addGameBBenchmarks(benchmarks);
+    addRunBodyBenchmarks(benchmarks);
+    addGiantBenchmarks(benchmarks);
+    addRulesBenchmarks(benchmarks);
+    addLevelBenchmarks(benchmarks);
+    addFloodBenchmarks(benchmarks);
+    addTimerBenchmarks(benchmarks);
+
+    int allocFailures = 0;
+    for (const auto &b : benchmarks) {
+        if (!filter.empty() && b.name.find(filter) == std::string::npos) continue;
+
+        for (int length : lengths) {
+            if (length < 1 || length > b.maxLength) continue;
+
+            BenchContext ctx(length, minTime);
+            ctx.perf = perf ? &counters : nullptr;
+            ctx.perTicks = perTicks;
+            b.run(ctx);
+            if (ctx.iterations == 0) continue; // benchmark skipped itself
+
+            BenchResult r;
+            r.name = b.name;
+            r.phase = b.phase;
+            r.boardW = b.boardW;
+            r.boardH = b.boardH;
+            r.length = length;
+            r.iterations = ctx.iterations;
+            r.nsPerOp = ctx.totalNs / ctx.iterations;
+            r.p50Ns = percentile(ctx.samples, 0.50);
+            r.p99Ns = percentile(ctx.samples, 0.99);
+            printResult(r, ctx, json);
+
+            if (checkAlloc && !b.mayAllocate && ctx.allocs) {
+                std::fprintf(stderr, "bench: %s (length %d) made %llu allocation(s) in %lld steady-state ops\n",
+                             b.name.c_str(), length, ctx.allocs, ctx.iterations);
+                allocFailures++;
+            }
+        }
+    }
+    std::fprintf(stderr, "bench: frame arena high water %zu of %zu bytes, %zu frame(s) spilled to the heap\n",
+                 frameArena().highWater(), frameArena().capacity(), frameArena().overflowFrames());
+    return allocFailures ? 1 : 0;
+}
@@ -0,0 +1,156 @@
+// Tiny benchmark harness shared by bench.cpp, bench_a.cpp and bench_b.cpp.
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+#include "alloctrack.h"
+#include "framearena.h"
+#include "perfcount.h"
+
+struct BenchResult {
+    std::string name;
+    int boardW, boardH; // tiles
+    int length;         // snake segments
+    const char *phase;
+    long long iterations;
+    double nsPerOp;
+    double p50Ns;
+    double p99Ns;
+};
+
+// Handed to each benchmark; the benchmark does its setup and then calls
+// measure() with the operation to time.
+class BenchContext {
+public:
+    BenchContext(int length, double minSeconds) : len(length), minTime(minSeconds) {}
+
+    int length() const { return len; }
+
+    // Attaches an extra number to the result, e.g. memory used or draw calls.
+    void report(const char *name, double value) { extras.push_back({name, value}); }
+
+    // Runs op in batches until minTime has passed. Each batch becomes one
+    // sample so that p50/p99 are not dominated by clock overhead. With
+    // perTicks set, the warm-up batches run as usual and then exactly that
+    // many ops are timed, each its own sample. Each op is treated as a frame:
+    // the frame arena is reset after it.
+    template <class F>
+    void measure(F&& op) {
+        using clock = std::chrono::steady_clock;
+
+        long long batch = 1;
+        for (;;) {
+            auto start = clock::now();
+            for (long long i = 0; i < batch; ++i) {
+                op();
+                frameArena().reset();
+            }
+            double ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+            if (ns >= 20000.0 || batch >= (1LL << 20)) break;
+            batch *= 2;
+        }
+        if (perTicks) batch = 1;
+
+        samples.clear();
+        perfSamples.clear();
+        perfTotal = PerfSample();
+        iterations = 0;
+        allocs = 0;
+        double total = 0.0;
+        while (perTicks ? iterations < perTicks : total < minTime * 1e9 || samples.size() < 50) {
+            PerfSample before = perf ? perf->read() : PerfSample();
+            unsigned long long allocsBefore = allocations();
+            auto start = clock::now();
+            for (long long i = 0; i < batch; ++i) {
+                op();
+                frameArena().reset();
+            }
+            double ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+            allocs += allocations() - allocsBefore;
+            if (perf) {
+                PerfSample delta = perf->read() - before;
+                perfTotal += delta;
+                if (perTicks) perfSamples.push_back(delta);
+            }
+            samples.push_back(ns / batch);
+            iterations += batch;
+            total += ns;
+        }
+        totalNs = total;
+    }
+
+    long long iterations = 0;
+    double totalNs = 0.0;
+    std::vector<double> samples; // ns per op, one per batch
+    unsigned long long allocs = 0; // heap allocations after the warm-up batches
+
+    // Set by the driver before run(); perf may be null.
+    PerfCounters *perf = nullptr;
+    long long perTicks = 0; // ticks to time one by one, or 0
+    PerfSample perfTotal;                 // over all timed iterations
+    std::vector<PerfSample> perfSamples; // one per tick when perTicks is set
+    std::vector<std::pair<const char *, double>> extras;
+
+private:
+    int len;
+    double minTime;
+};
+
+struct Benchmark {
+    std::string name;
+    const char *phase;  // update, collision, spawn, render or load
+    int boardW, boardH; // fixed by the game under test
+    int maxLength;      // longest snake the scenario can hold
+    std::function<void(BenchContext&)> run;
+    bool mayAllocate = false; // exempt from --check-alloc
+};
+
+void addGameABenchmarks(std::vector<Benchmark>& out);
+void addGameBBenchmarks(std::vector<Benchmark>& out);
+void addRunBodyBenchmarks(std::vector<Benchmark>& out);
+void addGiantBenchmarks(std::vector<Benchmark>& out);
+void addRulesBenchmarks(std::vector<Benchmark>& out);
+void addLevelBenchmarks(std::vector<Benchmark>& out);
+void addFloodBenchmarks(std::vector<Benchmark>& out);
+void addTimerBenchmarks(std::vector<Benchmark>& out);
+
+// Keeps the compiler from discarding a result that is only computed for timing.
+template <class T>
+inline void benchKeep(const T& value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Select SDL's dummy video driver and software renderer so render benchmarks
+// run on a headless box. Must be called before SDL_Init.
+inline void useHeadlessVideo() {
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+    SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+}
+
+// Hamiltonian cycle over a cols x rows block of tiles (cols must be even),
+// returned as pixel positions. A snake shorter than the cycle can follow it
+// forever without colliding with itself.
+inline std::vector<SDL_Point> serpentineCycle(int x0, int y0, int cols, int rows, int tile) {
+    std::vector<SDL_Point> cycle;
+    for (int c = 0; c < cols; ++c) {
+        if (c % 2 == 0)
+            for (int r = 1; r < rows; ++r) cycle.push_back({x0 + c * tile, y0 + r * tile});
+        else
+            for (int r = rows - 1; r >= 1; --r) cycle.push_back({x0 + c * tile, y0 + r * tile});
+    }
+    for (int c = cols - 1; c >= 0; --c) cycle.push_back({x0 + c * tile, y0});
+    return cycle;
+}
+
+// The cell after p on serpentineCycle(0, 0, cols, rows, 1), for boards too
+// big to store the whole cycle.
+inline SDL_Point serpentineNext(SDL_Point p, int cols, int rows) {
+    if (p.y == 0) return p.x > 0 ? SDL_Point{p.x - 1, 0} : SDL_Point{0, 1};
+    if (p.x % 2 == 0) return p.y < rows - 1 ? SDL_Point{p.x, p.y + 1} : SDL_Point{p.x + 1, p.y};
+    if (p.y > 1) return {p.x, p.y - 1};
+    return p.x < cols - 1 ? SDL_Point{p.x + 1, 1} : SDL_Point{p.x, 0};
+}
@@ -0,0 +1,105 @@
+// Benchmarks for the rules and rendering in a.cpp.
+#define SNAKE_NO_MAIN
+#include "a.cpp"
+#include "bench.h"
+
+struct SnakeGameBench {
+    static const int COLS = BoardGeometry::cols;
+    static const int ROWS = BoardGeometry::rows;
+
+    SnakeGame game;
+    vector<SDL_Point> cycle;
+    size_t headIndex = 0;
+
+    // Lays the snake out along a cycle covering the whole board. The apple is
+    // parked past the last tile so update() keeps the length constant.
+    explicit SnakeGameBench(int length, RenderMode mode = RENDER_FULL)
+        : game(mode), cycle(serpentineCycle(0, 0, COLS, ROWS, 1)) {
+        game.snakeBody.clear();
+        headIndex = length - 1;
+        for (int i = length - 1; i >= 0; --i)
+            game.snakeBody.push_back(BoardGeometry::index(cycle[i].x, cycle[i].y));
+        game.snakeHead = game.snakeBody.front();
+        game.snakeSize = length;
+        game.apple = Tile(BoardGeometry::cells);
+    }
+
+    // Points the snake at the next cell of the cycle and advances one tick.
+    void step() {
+        size_t next = (headIndex + 1) % cycle.size();
+        int dx = cycle[next].x - cycle[headIndex].x;
+        int dy = cycle[next].y - cycle[headIndex].y;
+        game.direction = dx > 0 ? RIGHT : dx < 0 ? LEFT : dy > 0 ? DOWN : UP;
+        game.update();
+        headIndex = next;
+    }
+
+    int obstacleHits(size_t cell) { return game.obstacleTiles[BoardGeometry::index(cycle[cell].x, cycle[cell].y)]; }
+
+    void clearObstacles() {
+        game.obstacles.clear();
+        game.markObstacleTiles();
+    }
+    void generateApple() { game.generateApple(); }
+    void render() { game.render(); }
+
+    // The pixels the next render() sends to the screen.
+    long long pixelsToSend() const {
+        if (!game.surface || game.fullRedraw) return (long long)WINDOW_WIDTH * WINDOW_HEIGHT;
+        return (long long)game.dirtyTiles.size() * TILE_SIZE * TILE_SIZE;
+    }
+};
+
+void addGameABenchmarks(vector<Benchmark>& out) {
+    const int cells = SnakeGameBench::COLS * SnakeGameBench::ROWS;
+
+    // The cycle crosses the obstacles, and hitting one blocks in pauseGame(),
+    // so movement is measured with the obstacle list cleared.
+    out.push_back({"a.update", "update", SnakeGameBench::COLS, SnakeGameBench::ROWS, cells - 2, [](BenchContext& ctx) {
+        SnakeGameBench bench(ctx.length());
+        bench.clearObstacles();
+        ctx.measure([&] { bench.step(); });
+    }});
+
+    out.push_back({"a.obstacles", "collision", SnakeGameBench::COLS, SnakeGameBench::ROWS, cells - 2, [](BenchContext& ctx) {
+        SnakeGameBench bench(ctx.length());
+        size_t i = 0;
+        int hits = 0;
+        ctx.measure([&] {
+            hits += bench.obstacleHits(i);
+            i = (i + 1) % bench.cycle.size();
+        });
+        benchKeep(hits);
+    }});
+
+    out.push_back({"a.generateApple", "spawn", SnakeGameBench::COLS, SnakeGameBench::ROWS, cells - 2, [](BenchContext& ctx) {
+        SnakeGameBench bench(ctx.length());
+        ctx.measure([&] { bench.generateApple(); });
+    }});
+
+    out.push_back({"a.render", "render", SnakeGameBench::COLS, SnakeGameBench::ROWS, cells - 2, [](BenchContext& ctx) {
+        SnakeGameBench bench(ctx.length());
+        bench.generateApple();
+        ctx.measure([&] { bench.render(); });
+    }});
+
+    // A whole tick drawn both ways, so the dirty-rectangle path has tiles to
+    // repaint. The headless renderer is the software one, as on the kiosks, so
+    // the dirty path draws into the window surface.
+    for (RenderMode mode : {RENDER_FULL, RENDER_DIRTY}) {
+        const char* name = mode == RENDER_FULL ? "a.frame" : "a.frame.dirty";
+        out.push_back({name, "render", SnakeGameBench::COLS, SnakeGameBench::ROWS, cells - 2, [mode](BenchContext& ctx) {
+            SnakeGameBench bench(ctx.length(), mode);
+            bench.clearObstacles();
+            bench.render();
+            long long pixels = 0, frames = 0;
+            ctx.measure([&] {
+                bench.step();
+                pixels += bench.pixelsToSend();
+                frames++;
+                bench.render();
+            });
+            ctx.report("pixels/frame", double(pixels) / double(frames));
+        }});
+    }
+}
@@ -0,0 +1,313 @@
+// Benchmarks for the rules and rendering in b.cpp.
+#define SNAKE_NO_MAIN
+#include "b.cpp"
+#include "bench.h"
+#include "floodfill.h"
+
+struct SnakeBench {
+    // The strip between the top wall and the inner walls is the largest
+    // wall-free rectangle: tiles 1..52 by 1..6.
+    static const int COLS = 52;
+    static const int ROWS = 6;
+
+    Snake snake;
+    std::vector<SDL_Point> cycle;
+    size_t headIndex = 0;
+
+    // Lays the snake out along a cycle through the wall-free strip. Food is
+    // parked in the corner wall so move() keeps the length constant.
+    explicit SnakeBench(int length) : cycle(serpentineCycle(1, 1, COLS, ROWS, 1)) {
+        snake.body.clear();
+        headIndex = length - 1;
+        for (int i = length - 1; i >= 0; --i)
+            snake.body.push_back(BoardGeometry::index(cycle[i].x, cycle[i].y));
+        snake.food = BoardGeometry::index(0, 0);
+        snake.bonusFoodActive = false;
+        gameOver = false;
+    }
+
+    void step() {
+        size_t next = (headIndex + 1) % cycle.size();
+        int dx = cycle[next].x - cycle[headIndex].x;
+        int dy = cycle[next].y - cycle[headIndex].y;
+        snake.direction = dx > 0 ? 3 : dx < 0 ? 2 : dy > 0 ? 1 : 0;
+        snake.move();
+        headIndex = next;
+    }
+
+    void placeFood(int x, int y) { snake.food = BoardGeometry::index(x, y); } // in tiles
+
+    // Covers the first `length` cells of the food area row by row. Not a
+    // snake that could be played into, but it is what spawnFood() sees late
+    // in a long game.
+    void fillFoodArea(int length) {
+        snake.body.clear();
+        for (int i = 0; i < length; ++i)
+            snake.body.push_back(BoardGeometry::index(1 + i % FOOD_COLS, 3 + i / FOOD_COLS));
+    }
+
+    SDL_Point head() const { return {BoardGeometry::x(snake.body[0]), BoardGeometry::y(snake.body[0])}; }
+
+    // The tiles a flood from the head may enter, neither wall nor body, as
+    // bits and as one byte per tile.
+    void openTiles(BitGrid &open, std::vector<uint8_t> &bytes) const {
+        open.resize(BoardGeometry::cols, BoardGeometry::rows);
+        bytes.assign(BoardGeometry::cells, 0);
+        for (int i = 0; i < BoardGeometry::cells; ++i) bytes[i] = !WALL_TILES[i];
+        for (Tile t : snake.body) bytes[t] = 0;
+        for (int i = 0; i < BoardGeometry::cells; ++i)
+            if (bytes[i]) open.set(BoardGeometry::x(Tile(i)), BoardGeometry::y(Tile(i)));
+    }
+
+    static const int FOOD_COLS = 52; // spawnFood() picks x tiles 1..52
+    static const int FOOD_ROWS = 28; // and y tiles 3..30
+};
+
+// Window and renderer for the render benchmarks, on the dummy video driver.
+struct HeadlessRenderer {
+    SDL_Window *window;
+    SDL_Renderer *renderer;
+
+    HeadlessRenderer() {
+        scoreText = nullptr; // owned by the previous renderer, already destroyed
+        SDL_Init(SDL_INIT_VIDEO);
+        window = SDL_CreateWindow("bench", 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, 0);
+        renderer = SDL_CreateRenderer(window, -1, 0);
+    }
+    ~HeadlessRenderer() {
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+    }
+};
+
+void addGameBBenchmarks(std::vector<Benchmark> &out) {
+    const int boardW = BoardGeometry::cols, boardH = BoardGeometry::rows;
+    const int maxLength = SnakeBench::COLS * SnakeBench::ROWS - 2;
+
+    out.push_back({"b.move", "update", boardW, boardH, maxLength, [](BenchContext &ctx) {
+        SnakeBench bench(ctx.length());
+        ctx.measure([&] { bench.step(); });
+    }});
+
+    out.push_back({"b.checkCollision", "collision", boardW, boardH, maxLength, [](BenchContext &ctx) {
+        SnakeBench bench(ctx.length());
+        bool hit = false;
+        ctx.measure([&] { hit |= bench.snake.checkCollision(); });
+        benchKeep(hit);
+    }});
+
+    // score % 5 != 0 keeps spawnFood() on the plain food path.
+    out.push_back({"b.spawnFood", "spawn", boardW, boardH, maxLength, [](BenchContext &ctx) {
+        SnakeBench bench(ctx.length());
+        score = 1;
+        ctx.measure([&] { bench.snake.spawnFood(); });
+        score = 0;
+    }});
+
+    out.push_back({"b.spawnFood.crowded", "spawn", boardW, boardH, SnakeBench::FOOD_COLS * SnakeBench::FOOD_ROWS - 1,
+                   [](BenchContext &ctx) {
+        SnakeBench bench(1);
+        bench.fillFoodArea(ctx.length());
+        score = 1;
+        ctx.measure([&] { bench.snake.spawnFood(); });
+        score = 0;
+    }});
+
+    // Tiles reachable from the head, as a bot would ask before each turn:
+    // packed rows against a queue over one byte per tile.
+    for (bool bitset : {true, false}) {
+        out.push_back({bitset ? "b.flood.bitset" : "b.flood.queue", "collision", boardW, boardH, maxLength,
+                       [bitset](BenchContext &ctx) {
+            SnakeBench bench(ctx.length());
+            BitGrid open;
+            std::vector<uint8_t> bytes;
+            bench.openTiles(open, bytes);
+            SDL_Point head = bench.head();
+            FloodFill fill;
+            QueueFloodFill queue;
+            FloodResult result;
+            auto op = [&] {
+                result = bitset ? fill.fill(open, head.x, head.y)
+                                : queue.fill(bytes, BoardGeometry::cols, BoardGeometry::rows, head.x, head.y);
+            };
+            op(); // sizes the scratch buffers
+            ctx.measure(op);
+            ctx.report("tiles", double(result.tiles));
+            if (bitset) ctx.report("sweeps", result.sweeps);
+        }});
+    }
+
+    out.push_back({"b.render", "render", boardW, boardH, maxLength, [](BenchContext &ctx) {
+        HeadlessRenderer r;
+        SnakeBench bench(ctx.length());
+        bench.placeFood(10, 10);
+        ctx.measure([&] {
+            SDL_SetRenderDrawColor(r.renderer, 204, 200, 153, 255);
+            SDL_RenderClear(r.renderer);
+            bench.snake.render(r.renderer);
+            SDL_RenderPresent(r.renderer);
+        });
+    }});
+
+    // The --textured picture: every sprite, walls included, goes out in one
+    // SDL_RenderGeometry call whatever the length.
+    out.push_back({"b.render.textured", "render", boardW, boardH, maxLength, [](BenchContext &ctx) {
+        HeadlessRenderer r;
+        Theme theme;
+        if (!theme.load(r.renderer, nullptr)) return;
+        SpriteBatch batch(theme.atlas);
+        SnakeBench bench(ctx.length());
+        bench.placeFood(10, 10);
+        int drawCalls = 0;
+        size_t sprites = 0;
+        ctx.measure([&] {
+            SDL_SetRenderDrawColor(r.renderer, 204, 200, 153, 255);
+            SDL_RenderClear(r.renderer);
+            bench.snake.render(batch, theme);
+            sprites = batch.spriteCount();
+            drawCalls = batch.flush(r.renderer);
+            SDL_RenderPresent(r.renderer);
+        });
+        ctx.report("draw_calls", drawCalls);
+        ctx.report("sprites", double(sprites));
+    }});
+
+    // The score stays the same, as it does on most frames of a game.
+    out.push_back({"b.renderScore", "render", boardW, boardH, 1, [](BenchContext &ctx) {
+        HeadlessRenderer r;
+        TextRenderer text(bakedfonts::arial28);
+        ctx.measure([&] { renderScore(r.renderer, text, 42); });
+    }});
+
+    // A new score every frame: the cost of rebuilding the text texture, from
+    // the baked glyphs and (.ttf, needs arial.ttf) from the TrueType font.
+    for (bool baked : {true, false}) {
+        out.push_back({baked ? "b.renderScore.change" : "b.renderScore.change.ttf", "render", boardW, boardH, 1,
+                       [baked](BenchContext &ctx) {
+            HeadlessRenderer r;
+            TTF_Init();
+            TextRenderer text(bakedfonts::arial28, "arial.ttf");
+            text.useBaked(baked);
+            if (baked || text.openFallback()) {
+                int value = 0;
+                ctx.measure([&] { renderScore(r.renderer, text, value++); });
+            }
+            text.close();
+            TTF_Quit();
+        }, true});
+    }
+
+    // Getting a font ready at startup: opening arial.ttf (915 KB) with
+    // SDL_ttf, against indexing the glyphs baked into the program.
+    out.push_back({"b.font.open.ttf", "render", boardW, boardH, 1, [](BenchContext &ctx) {
+        TTF_Init();
+        if (TTF_Font *probe = TTF_OpenFont("arial.ttf", 28)) {
+            TTF_CloseFont(probe);
+            ctx.measure([&] { TTF_CloseFont(TTF_OpenFont("arial.ttf", 28)); });
+        }
+        TTF_Quit();
+    }, true});
+
+    out.push_back({"b.font.open.baked", "render", boardW, boardH, 1, [](BenchContext &ctx) {
+        ctx.measure([&] {
+            TextRenderer text(bakedfonts::arial28);
+            benchKeep(text.covers("Score: 0"));
+        });
+    }});
+
+    // Whole frames from the software rasterizer: the game's 1080x720, and a
+    // 3840x2160 frame that upscales it x3 with a letterbox. Frame rates are
+    // reported as "fps".
+    struct SoftCase {
+        const char *name;
+        SoftFramebuffer::Format format;
+        int scale; // 1, or 3 for 4K
+        SimdLevel simd;
+    };
+    static const SoftCase softCases[] = {
+        {"b.soft.frame", SoftFramebuffer::RGBA32, 1, SIMD_AVX2},
+        {"b.soft.frame.sse2", SoftFramebuffer::RGBA32, 1, SIMD_SSE2},
+        {"b.soft.frame.scalar", SoftFramebuffer::RGBA32, 1, SIMD_SCALAR},
+        {"b.soft.frame.indexed", SoftFramebuffer::INDEXED8, 1, SIMD_AVX2},
+        {"b.soft.frame.4k", SoftFramebuffer::INDEXED8, 3, SIMD_AVX2},
+        {"b.soft.frame.4k.rgba", SoftFramebuffer::RGBA32, 3, SIMD_AVX2},
+    };
+    for (const SoftCase &c : softCases) {
+        out.push_back({c.name, "render", boardW, boardH, maxLength, [c](BenchContext &ctx) {
+            TextRenderer text(bakedfonts::arial28);
+            SnakeBench bench(ctx.length());
+            bench.placeFood(10, 10);
+            SoftFramebuffer frame(SCREEN_WIDTH, SCREEN_HEIGHT, c.format);
+            SoftFramebuffer screen(c.scale > 1 ? 3840 : 0, c.scale > 1 ? 2160 : 0, SoftFramebuffer::RGBA32);
+            const int ox = (screen.width() - SCREEN_WIDTH * c.scale) / 2, oy = (screen.height() - SCREEN_HEIGHT * c.scale) / 2;
+            uint32_t background = frame.map(204, 200, 153);
+            ScoreLabel label;
+            renderScore(frame, text, 42, label); // rasterize the text outside the timed loop
+            screen.clear(0);
+
+            SimdLevel previous = simdLevel();
+            useSimd(c.simd);
+            ctx.measure([&] {
+                frame.clear(background);
+                bench.snake.render(frame);
+                renderScore(frame, text, 42, label);
+                if (c.scale > 1) frame.upscaleTo(screen, c.scale, ox, oy);
+            });
+            ctx.report("simd", simdLevel());
+            ctx.report("fps", 1e9 * ctx.iterations / ctx.totalNs);
+            useSimd(previous);
+        }});
+    }
+
+    // What the always-on clip ring adds to a tick: capturing the state and
+    // encoding its record. The ring is filled first, so this is the steady
+    // state, which reuses segment buffers. "bytes" is the ring's size.
+    out.push_back({"b.clip.record", "update", boardW, boardH, maxLength, [](BenchContext &ctx) {
+        SnakeBench bench(ctx.length());
+        ClipRecorder clips(SCREEN_WIDTH, SCREEN_HEIGHT, TILE_SIZE, 10, CLIP_SECONDS);
+        ReplayState state;
+        for (size_t i = 0; i < clips.framesWanted() + 2 * ClipRecorder::KEYFRAME_INTERVAL; ++i) {
+            bench.step();
+            bench.snake.capture(state);
+            clips.frame(state);
+        }
+        ctx.measure([&] {
+            bench.step();
+            bench.snake.capture(state);
+            clips.frame(state);
+        });
+        ctx.report("bytes", double(clips.memoryBytes()));
+    }});
+
+    // What a screenshot adds to the frame that takes it. ScreenshotWriter
+    // only reads the frame back into a pooled buffer; encoding in the frame
+    // instead (.inline.*) would add the encode as well.
+    struct ShotCase {
+        const char *name;
+        int encode; // -1: read-back only, else a ScreenshotWriter::Format
+    };
+    static const ShotCase shotCases[] = {
+        {"b.screenshot.readback", -1},
+        {"b.screenshot.inline.png", ScreenshotWriter::PNG},
+        {"b.screenshot.inline.bmp", ScreenshotWriter::BMP},
+    };
+    for (const ShotCase &c : shotCases) {
+        out.push_back({c.name, "render", boardW, boardH, maxLength, [c](BenchContext &ctx) {
+            HeadlessRenderer r;
+            SnakeBench bench(ctx.length());
+            bench.placeFood(10, 10);
+            SDL_SetRenderDrawColor(r.renderer, 204, 200, 153, 255);
+            SDL_RenderClear(r.renderer);
+            bench.snake.render(r.renderer);
+
+            std::vector<uint8_t> pixels(size_t(SCREEN_WIDTH) * SCREEN_HEIGHT * 4), file;
+            SDL_Rect area = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+            ctx.measure([&] {
+                SDL_RenderReadPixels(r.renderer, &area, SDL_PIXELFORMAT_RGBA32, pixels.data(), SCREEN_WIDTH * 4);
+                if (c.encode == ScreenshotWriter::PNG) encodePng(file, pixels.data(), SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_WIDTH * 4);
+                else if (c.encode == ScreenshotWriter::BMP) encodeBmp(file, pixels.data(), SCREEN_WIDTH, SCREEN_HEIGHT, SCREEN_WIDTH * 4);
+            });
+        }, c.encode == ScreenshotWriter::PNG});
+    }
+}
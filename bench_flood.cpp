@@ -0,0 +1,74 @@
+// Benchmarks for flood fills (floodfill.h) on 1024x1024 boards: the packed
+// row fill, with and without AVX2, against a queue over one byte per tile.
+#include "bench.h"
+#include "floodfill.h"
+#include "levelgen.h"
+
+struct FloodBoard {
+    BitGrid open, target;
+    std::vector<uint8_t> bytes, targetBytes;
+    SDL_Point start;
+};
+
+// A generated level with its spawn as the start. The target, when wanted, is
+// a tile near the start, as when a bot asks whether its tail is in reach.
+static FloodBoard floodBoard(LevelStyle style, double density, int size) {
+    LevelParams params;
+    params.style = style;
+    params.density = density;
+    params.cols = params.rows = size;
+    LevelData level = generateLevel(params, 1);
+
+    FloodBoard board;
+    board.open.resize(size, size);
+    board.target.resize(size, size);
+    board.bytes.assign(level.walls.size(), 0);
+    board.targetBytes.assign(level.walls.size(), 0);
+    for (int y = 0; y < size; ++y)
+        for (int x = 0; x < size; ++x)
+            if (!level.walls[size_t(y) * size + x]) {
+                board.open.set(x, y);
+                board.bytes[size_t(y) * size + x] = 1;
+            }
+    board.start = {level.spawns[0].x, level.spawns[0].y};
+    SDL_Point t = {board.start.x + level.spawns[0].dx * 6, board.start.y + level.spawns[0].dy * 6}; // on the runway
+    board.target.set(t.x, t.y);
+    board.targetBytes[size_t(t.y) * size + t.x] = 1;
+    return board;
+}
+
+void addFloodBenchmarks(std::vector<Benchmark> &out) {
+    const int size = 1024;
+    enum Kind { AVX2, SCALAR, QUEUE };
+    struct Case { const char *name; LevelStyle style; double density; Kind kind; bool target; };
+    static const Case cases[] = {
+        {"flood.open.bitset", LevelStyle::PILLARS, 0.15, AVX2, false},
+        {"flood.open.bitset.scalar", LevelStyle::PILLARS, 0.15, SCALAR, false},
+        {"flood.open.queue", LevelStyle::PILLARS, 0.15, QUEUE, false},
+        {"flood.maze.bitset", LevelStyle::MAZE, 0.9, AVX2, false},
+        {"flood.maze.bitset.scalar", LevelStyle::MAZE, 0.9, SCALAR, false},
+        {"flood.maze.queue", LevelStyle::MAZE, 0.9, QUEUE, false},
+        {"flood.open.bitset.target", LevelStyle::PILLARS, 0.15, AVX2, true},
+        {"flood.open.queue.target", LevelStyle::PILLARS, 0.15, QUEUE, true},
+    };
+    for (const Case &c : cases) {
+        out.push_back({c.name, "collision", size, size, 1, [c, size](BenchContext &ctx) {
+            FloodBoard board = floodBoard(c.style, c.density, size);
+            FloodFill fill;
+            fill.useAvx2(c.kind == AVX2);
+            QueueFloodFill queue;
+            FloodResult result;
+            auto op = [&] {
+                if (c.kind == QUEUE)
+                    result = queue.fill(board.bytes, size, size, board.start.x, board.start.y,
+                                        c.target ? &board.targetBytes : nullptr);
+                else
+                    result = fill.fill(board.open, board.start.x, board.start.y, c.target ? &board.target : nullptr);
+            };
+            op(); // sizes the scratch buffers
+            ctx.measure(op);
+            ctx.report("tiles", double(result.tiles));
+            if (c.kind != QUEUE) ctx.report("sweeps", result.sweeps);
+        }});
+    }
+}
@@ -0,0 +1,148 @@
+// Benchmarks for the giant-board mode in giant.h across board sizes.
+#include "bench.h"
+#include "giant.h"
+#include "minimap.h"
+
+static const int VIEW_W = 1080 / 20, VIEW_H = 720 / 20; // giant.cpp's window in tiles
+
+struct GiantBench {
+    GiantGame game;
+    int size;
+    SDL_Point next;
+
+    // Replaces the starting snake with one of the given length laid along the
+    // serpentine, and takes the food off the board so the length holds.
+    GiantBench(int boardSize, int length, bool walls) : game(boardSize, boardSize, 1, walls), size(boardSize) {
+        SDL_Point start = game.body.head();
+        game.board.set(start.x, start.y, EMPTY);
+        game.removeItem(game.food.x, game.food.y);
+
+        SDL_Point p = {0, 1};
+        game.body.reset(p.x, p.y);
+        game.board.set(p.x, p.y, SNAKE);
+        next = serpentineNext(p, size, size);
+        for (int i = 1; i < length; ++i) {
+            SDL_Point h = game.body.head();
+            game.body.advanceHead(next.x - h.x, next.y - h.y);
+            game.board.set(next.x, next.y, SNAKE);
+            next = serpentineNext(next, size, size);
+        }
+    }
+
+    bool step() {
+        SDL_Point h = game.body.head();
+        bool alive = game.step(next.x - h.x, next.y - h.y);
+        next = serpentineNext(next, size, size);
+        return alive;
+    }
+};
+
+// A snake going round a 64x64 square with ghost on, so once it is longer
+// than the square's 252 tiles it lies over itself length / 252 times and
+// every step both crosses the body and frees a crossed tile.
+struct GhostBench {
+    GiantGame game;
+    int dir = 0, run = 0;
+
+    GhostBench(int boardSize, int length) : game(boardSize, boardSize, 1, false) {
+        game.removeItem(game.food.x, game.food.y);
+        game.growth = length - 1;
+        game.startEffect(ITEM_GHOST);
+        for (int i = 1; i < length; ++i) step();
+    }
+
+    bool step() {
+        static const int DIRS[4][2] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+        if (++run == 64) {
+            run = 1;
+            dir = (dir + 1) & 3;
+            game.startEffect(ITEM_GHOST); // well inside EFFECT_TICKS
+        }
+        return game.step(DIRS[dir][0], DIRS[dir][1]);
+    }
+};
+
+// One renderer shared by every giant.render run, on the dummy video driver.
+static SDL_Renderer *benchRenderer() {
+    static SDL_Renderer *renderer = nullptr;
+    if (!renderer) {
+        SDL_Init(SDL_INIT_VIDEO);
+        SDL_Window *window = SDL_CreateWindow("bench", 0, 0, VIEW_W * 20, VIEW_H * 20, 0);
+        renderer = SDL_CreateRenderer(window, -1, 0);
+    }
+    return renderer;
+}
+
+void addGiantBenchmarks(std::vector<Benchmark> &out) {
+    for (int size : {64, 512, 4096, 8192}) {
+        const int maxLength = size * size / 4;
+
+        // Chunks are allocated the first time the snake enters them.
+        out.push_back({"giant.step", "update", size, size, maxLength, [size](BenchContext &ctx) {
+            GiantBench bench(size, ctx.length(), false);
+            bool alive = true;
+            ctx.measure([&] { alive &= bench.step(); });
+            benchKeep(alive);
+        }, true});
+
+        // The same walk with 100k food items and power-ups about the board.
+        // Only a step onto an item looks in the pool, so the cost per step
+        // should match giant.step's.
+        if (size >= 4096)
+            out.push_back({"giant.step.items", "update", size, size, maxLength, [size](BenchContext &ctx) {
+                GiantBench bench(size, ctx.length(), false);
+                size_t placed = bench.game.scatterItems(100000);
+                int score = bench.game.score;
+                bool alive = true;
+                ctx.measure([&] { alive &= bench.step(); });
+                benchKeep(alive);
+                ctx.report("items", double(placed));
+                ctx.report("eaten", bench.game.score - score);
+            }, true});
+
+        // Going over its own body: the tail's step off a crossed tile costs the
+        // same however long the snake is.
+        if (size >= 4096)
+            out.push_back({"giant.step.ghost", "update", size, size, maxLength, [size](BenchContext &ctx) {
+                GhostBench bench(size, ctx.length());
+                bool alive = true;
+                ctx.measure([&] { alive &= bench.step(); });
+                benchKeep(alive);
+                ctx.report("alive", alive);
+            }, true});
+
+        out.push_back({"giant.render", "render", size, size, maxLength, [size](BenchContext &ctx) {
+            GiantBench bench(size, ctx.length(), true);
+            SDL_Renderer *renderer = benchRenderer();
+            Camera camera(VIEW_W, VIEW_H);
+            camera.follow(bench.game.body.head(), size, size);
+            int rects = 0;
+            ctx.measure([&] {
+                SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+                SDL_RenderClear(renderer);
+                rects = bench.game.render(renderer, camera, 20);
+                SDL_RenderPresent(renderer);
+            });
+            ctx.report("rects", rects);
+            ctx.report("chunks", bench.game.board.allocatedChunks());
+        }});
+
+        // A tick plus the minimap upload that follows it; the upload should
+        // stay a handful of pixels however big the board is.
+        out.push_back({"giant.minimap", "render", size, size, maxLength, [size](BenchContext &ctx) {
+            GiantBench bench(size, ctx.length(), false);
+            SDL_Renderer *renderer = benchRenderer();
+            Minimap minimap(bench.game.board, 256, 4);
+            bench.game.board.observe(&minimap);
+            minimap.upload(renderer, 0);
+            bool alive = true;
+            ctx.measure([&] {
+                alive &= bench.step();
+                minimap.upload(renderer, 0);
+            });
+            bench.game.board.observe(nullptr);
+            benchKeep(alive);
+            ctx.report("pixels", minimap.lastUploadPixels());
+        }, true});
+    }
+}
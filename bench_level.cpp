@@ -0,0 +1,113 @@
+// Benchmarks for level files (level.h): mapping a level against reading its
+// ASCII form, and opening one that another game already has open; and for
+// generating levels (levelgen.h).
+#include <cstdio>
+#include <string>
+#include "bench.h"
+#include "imageio.h"
+#include "level.h"
+#include "levelgen.h"
+
+// A size x size level: a border, and a pillar every 8 tiles.
+static LevelData pillarLevel(int size) {
+    LevelData level;
+    level.cols = level.rows = size;
+    level.walls.assign(size_t(size) * size, 0);
+    for (int y = 0; y < size; ++y)
+        for (int x = 0; x < size; ++x)
+            level.walls[size_t(y) * size + x] = x == 0 || y == 0 || x == size - 1 || y == size - 1 || (x % 8 == 4 && y % 8 == 4);
+    level.spawns.push_back({size / 2, size / 2 + 1, 1, 0});
+    level.food.push_back({1, 1, size - 2, size - 2});
+    return level;
+}
+
+// Whether every open tile can be reached from the first spawn.
+static bool connected(const LevelData &level) {
+    std::vector<uint8_t> seen(level.walls.size());
+    std::vector<int> todo = {level.spawns[0].y * level.cols + level.spawns[0].x};
+    seen[todo[0]] = 1;
+    while (!todo.empty()) {
+        int i = todo.back(), x = i % level.cols, y = i / level.cols;
+        todo.pop_back();
+        for (int n : {x > 0 ? i - 1 : -1, x + 1 < level.cols ? i + 1 : -1, y > 0 ? i - level.cols : -1,
+                      y + 1 < level.rows ? i + level.cols : -1})
+            if (n >= 0 && !seen[n] && !level.walls[n]) seen[n] = 1, todo.push_back(n);
+    }
+    for (size_t i = 0; i < seen.size(); ++i)
+        if (!seen[i] && !level.walls[i]) return false;
+    return true;
+}
+
+void addLevelBenchmarks(std::vector<Benchmark> &out) {
+    for (int size : {1024, 4096}) {
+        // Maps the file, checks the header and reads one wall. Nothing else is
+        // open, so every op makes a new mapping.
+        out.push_back({"level.open." + std::to_string(size), "load", size, size, 1, [size](BenchContext &ctx) {
+            std::string path = "bench_level_" + std::to_string(size) + ".lvl";
+            std::vector<uint8_t> file = encodeLevel(pillarLevel(size));
+            if (!writeFile(path.c_str(), file)) return;
+            bool wall = false;
+            ctx.measure([&] {
+                std::shared_ptr<const Level> level = openLevel(path);
+                wall ^= level && level->wall(4, 4);
+            });
+            benchKeep(wall);
+            ctx.report("bytes", double(file.size()));
+            std::remove(path.c_str());
+        }, true});
+    }
+
+    // A second game opening a level the first one holds gets the same mapping.
+    out.push_back({"level.open.shared", "load", 4096, 4096, 1, [](BenchContext &ctx) {
+        const std::string path = "bench_level_shared.lvl";
+        if (!writeFile(path.c_str(), encodeLevel(pillarLevel(4096)))) return;
+        std::shared_ptr<const Level> first = openLevel(path);
+        bool same = true;
+        ctx.measure([&] { same &= openLevel(path) == first; });
+        ctx.report("shared", same);
+        first.reset();
+        std::remove(path.c_str());
+    }, true});
+
+    // What loading would cost if levels were read from their ASCII form.
+    out.push_back({"level.parse.1024", "load", 1024, 1024, 1, [](BenchContext &ctx) {
+        std::string text = formatAsciiLevel(pillarLevel(1024));
+        LevelData level;
+        std::string error;
+        ctx.measure([&] { parseAsciiLevel(text, level, error); });
+        ctx.report("bytes", double(text.size()));
+    }, true});
+
+    // A new level per op, as a training run asking for level ids in turn
+    // would. The first few hundred are checked for reachability as well.
+    struct Style { const char *name; LevelStyle style; double density; int size; };
+    for (Style st : {Style{"pillars", LevelStyle::PILLARS, 0.15, 54}, Style{"rooms", LevelStyle::ROOMS, 0.5, 54},
+                     Style{"maze", LevelStyle::MAZE, 0.8, 54}, Style{"rooms", LevelStyle::ROOMS, 0.5, 256}}) {
+        std::string name = std::string("levelgen.") + st.name + (st.size == 54 ? "" : "." + std::to_string(st.size));
+        out.push_back({name, "load", st.size, st.size * 2 / 3, 1, [st](BenchContext &ctx) {
+            LevelParams params;
+            params.style = st.style;
+            params.density = st.density;
+            params.cols = st.size;
+            params.rows = st.size * 2 / 3;
+            LevelGenerator generator;
+            LevelData level;
+            int unreachable = 0;
+            for (uint64_t id = 0; id < 200; ++id) {
+                generator.generate(params, id, level);
+                unreachable += !connected(level);
+            }
+            uint64_t id = 0;
+            size_t walls = 0;
+            ctx.measure([&] {
+                generator.generate(params, id++, level);
+                walls += level.walls[level.cols + 1];
+            });
+            benchKeep(walls);
+            size_t wallTiles = 0;
+            for (uint8_t w : level.walls) wallTiles += w != 0;
+            ctx.report("wall%", 100.0 * wallTiles / level.walls.size());
+            ctx.report("unreachable", unreachable);
+        }, true});
+    }
+}
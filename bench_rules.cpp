@@ -0,0 +1,186 @@
+// Benchmarks for the rule engine in rules.h: each game's rules as a
+// compile-time variant and as the same rules read from a RuleConfig.
+#include "bench.h"
+#include "rules.h"
+
+using namespace rules;
+
+// a.cpp's 640x440 window and its two bars, in tiles. The horizontal bar sits
+// at y 110..130, half a tile off the grid, so it blocks rows 5 and 6.
+static Board boardA() {
+    Board board(32, 22, {0, 11});
+    board.addWall(8, 5, 5, 2);
+    board.addWall(16, 11, 1, 5);
+    return board;
+}
+
+// b.cpp's WALLS, in tiles, with the HUD strip at the bottom as wall.
+static Board boardB() {
+    Board board(54, 36, {3, 3});
+    board.addWall(28, 7, 1, 17);
+    board.addWall(20, 15, 17, 1);
+    board.addWall(5, 7, 1, 20);
+    board.addWall(48, 7, 1, 20);
+    board.addWall(0, 32, 54, 4);
+    board.addWall(0, 0, 1, 36);
+    board.addWall(53, 0, 1, 36);
+    board.addWall(0, 0, 54, 1);
+    return board;
+}
+
+// Heads for the food, taking the first safe direction, and now and then
+// wanders off in a random one for a few ticks so it does not sit in a corner
+// behind a wall. Starts over when the snake dies. Both variants make the same
+// moves for the same seed. It looks no further than the next tile, so it
+// often seals itself in, as bulk-simulation bots do.
+template <class Game>
+struct RulesBench {
+    Game game;
+    int deaths = 0, pauses = 0, trapped = 0;
+    long long ticks = 0, saved = 0; // saved: ticks a trap check would have cut
+    uint32_t random = 1;
+    int wander = 0, way = 0;
+
+    explicit RulesBench(Game g) : game(std::move(g)) {}
+
+    void tick() {
+        static const int DIRS[4][2] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+        random ^= random << 13;
+        random ^= random >> 17;
+        random ^= random << 5;
+        if (wander == 0 && random % 16 == 0) {
+            wander = 4 + random / 16 % 16;
+            way = random / 256 % 4;
+        }
+
+        SDL_Point f = game.offsetTo(game.food());
+        const int toFood[2][2] = {{f.x > 0 ? 1 : -1, 0}, {0, f.y > 0 ? 1 : -1}};
+        if (wander > 0 && game.canEnter(DIRS[way][0], DIRS[way][1])) {
+            game.steer(DIRS[way][0], DIRS[way][1]);
+            wander--;
+        } else if (f.x && game.canEnter(toFood[0][0], toFood[0][1])) {
+            wander = 0;
+            game.steer(toFood[0][0], toFood[0][1]);
+        } else if (f.y && game.canEnter(toFood[1][0], toFood[1][1])) {
+            wander = 0;
+            game.steer(toFood[1][0], toFood[1][1]);
+        } else {
+            wander = 0;
+            for (const auto &d : DIRS)
+                if (game.canEnter(d[0], d[1])) {
+                    game.steer(d[0], d[1]);
+                    break;
+                }
+        }
+        ticks++;
+        switch (game.step()) {
+        case DIED:
+            deaths++;
+            restart();
+            break;
+        case TRAPPED:
+            trapped++;
+            restart();
+            break;
+        case PAUSED:
+            // A player boxed in against an obstacle would quit rather than pay again.
+            pauses++;
+            if (boxedIn()) {
+                deaths++;
+                restart();
+            } else {
+                game.resume();
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    void restart() {
+        if (game.trappedAt() >= 0) saved += game.ticks() - game.trappedAt();
+        game.reset();
+    }
+
+    bool boxedIn() const {
+        return !game.canEnter(1, 0) && !game.canEnter(-1, 0) && !game.canEnter(0, 1) && !game.canEnter(0, -1);
+    }
+};
+
+template <class Game>
+static void measureRules(BenchContext &ctx, Game game) {
+    RulesBench<Game> bench(std::move(game));
+    ctx.measure([&] { bench.tick(); });
+    ctx.report("deaths", bench.deaths);
+    ctx.report("pauses", bench.pauses);
+    ctx.report("length", bench.game.size());
+    if (bench.trapped) ctx.report("trapped", bench.trapped);
+    if (bench.saved) ctx.report("saved_per_10k", 1e4 * bench.saved / bench.ticks);
+    ctx.report("ticks/game", double(bench.ticks) / std::max(1, bench.deaths + bench.trapped));
+}
+
+void addRulesBenchmarks(std::vector<Benchmark> &out) {
+    static const Board a = boardA(), b = boardB();
+    static const Board open(32, 22, {0, 11}), square(32, 32, {0, 16}); // test.cpp's board, and one with masks
+    const unsigned seed = 42;
+
+    // Walled against wrapping: with no edge to die on the snake lives longer
+    // and grows, so compare ns per tick rather than deaths.
+    out.push_back({"rules.walled", "update", open.cols, open.rows, 1, [=](BenchContext &ctx) {
+        measureRules(ctx, ClassicGame(open, seed));
+    }});
+    out.push_back({"rules.wrap", "update", open.cols, open.rows, 1, [=](BenchContext &ctx) {
+        measureRules(ctx, WrapGame(open, seed));
+    }});
+    out.push_back({"rules.walled.pow2", "update", square.cols, square.rows, 1, [=](BenchContext &ctx) {
+        measureRules(ctx, ClassicGame(square, seed));
+    }});
+    out.push_back({"rules.wrap.pow2", "update", square.cols, square.rows, 1, [=](BenchContext &ctx) {
+        measureRules(ctx, MaskedWrapGame(square, seed));
+    }});
+
+    out.push_back({"rules.a.templated", "update", a.cols, a.rows, 1, [=](BenchContext &ctx) {
+        measureRules(ctx, ObstacleGame(a, seed));
+    }});
+    out.push_back({"rules.a.runtime", "update", a.cols, a.rows, 1, [=](BenchContext &ctx) {
+        RuleConfig config;
+        config.obstacle = ObstacleRule::PAUSE;
+        config.penalty = 10;
+        measureRules(ctx, makeGame(a, config, seed));
+    }});
+
+    // Trap checks on the same games: ending them (.traps) against only noting
+    // the tick, which reports how many of every 10000 ticks ending would save.
+    using TrappedClassic = SnakeEngine<EdgeKills, ObstacleKills, OneFood, Points<1>, TrapsEnd>;
+    using NotedClassic = SnakeEngine<EdgeKills, ObstacleKills, OneFood, Points<1>, TrapsNoted>;
+    out.push_back({"rules.walled.traps", "update", open.cols, open.rows, 1, [=](BenchContext &ctx) {
+        measureRules(ctx, TrappedClassic(open, seed));
+    }});
+    out.push_back({"rules.walled.traps.noted", "update", open.cols, open.rows, 1, [=](BenchContext &ctx) {
+        measureRules(ctx, NotedClassic(open, seed));
+    }});
+
+    out.push_back({"rules.b.templated", "update", b.cols, b.rows, 1, [=](BenchContext &ctx) {
+        measureRules(ctx, BonusGame(b, seed));
+    }});
+    out.push_back({"rules.b.runtime", "update", b.cols, b.rows, 1, [=](BenchContext &ctx) {
+        RuleConfig config;
+        config.bonusEvery = 5;
+        config.bonusTicks = 70;
+        config.bonusPoints = 10;
+        measureRules(ctx, makeGame(b, config, seed));
+    }});
+
+    using TrappedBonus = SnakeEngine<EdgeKills, ObstacleKills, BonusFood<5, 70>, Points<1, 10>, TrapsEnd>;
+    out.push_back({"rules.b.traps", "update", b.cols, b.rows, 1, [=](BenchContext &ctx) {
+        measureRules(ctx, TrappedBonus(b, seed));
+    }});
+    out.push_back({"rules.b.traps.noted", "update", b.cols, b.rows, 1, [=](BenchContext &ctx) {
+        RuleConfig config;
+        config.bonusEvery = 5;
+        config.bonusTicks = 70;
+        config.bonusPoints = 10;
+        config.trap = TrapRule::NOTE;
+        measureRules(ctx, makeGame(b, config, seed));
+    }});
+}
@@ -0,0 +1,74 @@
+// Benchmarks for the run-length encoded body in runbody.h, next to the
+// one-rect-per-segment deque a.cpp used to keep.
+#include <deque>
+#include "bench.h"
+#include "runbody.h"
+
+static const int BOARD = 2048; // tiles per side; the serpentine turns every BOARD cells
+
+struct RunBodyBench {
+    RunBody body;
+    SDL_Point next;
+
+    explicit RunBodyBench(int length) {
+        body.reset(0, 1);
+        next = serpentineNext({0, 1}, BOARD, BOARD);
+        for (int i = 1; i < length; ++i) advance();
+    }
+
+    void advance() {
+        SDL_Point h = body.head();
+        body.advanceHead(next.x - h.x, next.y - h.y);
+        next = serpentineNext(next, BOARD, BOARD);
+    }
+};
+
+void addRunBodyBenchmarks(std::vector<Benchmark> &out) {
+    const int maxLength = BOARD * BOARD - 2;
+
+    out.push_back({"runbody.step", "update", BOARD, BOARD, maxLength, [](BenchContext &ctx) {
+        RunBodyBench bench(ctx.length());
+        ctx.measure([&] {
+            bench.advance();
+            bench.body.retractTail();
+        });
+        ctx.report("runs", bench.body.runCount());
+        ctx.report("bytes", bench.body.memoryBytes());
+    }});
+
+    out.push_back({"runbody.contains", "collision", BOARD, BOARD, maxLength, [](BenchContext &ctx) {
+        RunBodyBench bench(ctx.length());
+        bool hit = false;
+        ctx.measure([&] { hit |= bench.body.contains(bench.next.x, bench.next.y); });
+        benchKeep(hit);
+    }});
+
+    out.push_back({"runbody.rects", "render", BOARD, BOARD, maxLength, [](BenchContext &ctx) {
+        RunBodyBench bench(ctx.length());
+        size_t rects = 0;
+        ctx.measure([&] {
+            std::pmr::vector<SDL_Rect> out(&frameArena());
+            out.reserve(bench.body.runCount());
+            bench.body.appendRects(out, 1);
+            rects = out.size();
+        });
+        ctx.report("draw_calls", rects);
+    }});
+
+    // The same walk with one SDL_Rect per segment.
+    out.push_back({"rects.step", "update", BOARD, BOARD, maxLength, [](BenchContext &ctx) {
+        std::deque<SDL_Rect> body;
+        SDL_Point p = {0, 1};
+        for (int i = 0; i < ctx.length(); ++i) {
+            body.push_front({p.x, p.y, 1, 1});
+            p = serpentineNext(p, BOARD, BOARD);
+        }
+        ctx.measure([&] {
+            body.push_front({p.x, p.y, 1, 1});
+            body.pop_back();
+            p = serpentineNext(p, BOARD, BOARD);
+        });
+        ctx.report("draw_calls", body.size());
+        ctx.report("bytes", body.size() * sizeof(SDL_Rect));
+    }, true});
+}
@@ -0,0 +1,60 @@
+// Benchmarks for timed events (timerwheel.h): one tick with thousands of
+// timers pending, on the wheel and on a list checked every tick, as b.cpp
+// checked its bonus food.
+#include <string>
+#include "bench.h"
+#include "timerwheel.h"
+
+// Lifetimes from a bonus food's to a long power-up's, in ticks.
+static uint64_t lifetime(uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return 20 + state % 2000;
+}
+
+void addTimerBenchmarks(std::vector<Benchmark> &out) {
+    for (int timers : {1000, 100000}) {
+        // Every timer that fires is set again, so as many stay pending.
+        out.push_back({"timers.wheel." + std::to_string(timers), "update", 0, 0, timers, [timers](BenchContext &ctx) {
+            TimerWheel<uint32_t> wheel;
+            wheel.reserve(timers);
+            uint32_t state = 1;
+            for (int i = 0; i < timers; ++i) wheel.after(lifetime(state), uint32_t(i));
+            uint64_t fired = 0;
+            ctx.measure([&] {
+                wheel.advance([&](uint32_t item) {
+                    fired++;
+                    wheel.after(lifetime(state), item);
+                });
+            });
+            ctx.report("fired/tick", double(fired) / double(wheel.now()));
+            ctx.report("pending", double(wheel.size()));
+        }});
+
+        out.push_back({"timers.scan." + std::to_string(timers), "update", 0, 0, timers, [timers](BenchContext &ctx) {
+            std::vector<uint64_t> due(timers);
+            uint32_t state = 1;
+            for (uint64_t &d : due) d = lifetime(state);
+            uint64_t tick = 0, fired = 0;
+            ctx.measure([&] {
+                tick++;
+                for (uint64_t &d : due)
+                    if (d <= tick) {
+                        fired++;
+                        d = tick + lifetime(state);
+                    }
+            });
+            ctx.report("fired/tick", double(fired) / double(tick));
+        }});
+    }
+
+    // A bonus food eaten before it runs out: its timer is set and cancelled.
+    out.push_back({"timers.wheel.cancel", "update", 0, 0, 1, [](BenchContext &ctx) {
+        TimerWheel<uint32_t> wheel;
+        wheel.reserve(1);
+        bool cancelled = true;
+        ctx.measure([&] { cancelled &= wheel.cancel(wheel.after(70, 0)); });
+        ctx.report("cancelled", cancelled);
+    }});
+}
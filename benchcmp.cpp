@@ -0,0 +1,226 @@
+// Runs bench several times and compares the results against a stored baseline.
+//
+//   benchcmp record BASELINE.jsonl [--runs N] [--bench PATH] [-- BENCH ARGS]
+//   benchcmp compare BASELINE.jsonl [NEW.jsonl] [--runs N] [--bench PATH]
+//                    [--threshold PERCENT] [--alpha P] [-- BENCH ARGS]
+//
+// A baseline is bench's --json output from every run, one result per line with
+// a "run" field added. compare runs bench again (or reads NEW.jsonl), and for
+// each benchmark compares the per-run ns_per_op and p99_ns with a one-sided
+// Mann-Whitney U test. A metric regresses when its median got worse by more
+// than the threshold and the test is significant; any regression exits with 1.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+struct Sample {
+    std::string key; // bench name, board and length
+    std::string line;
+    double nsPerOp;
+    double p99Ns;
+};
+
+// Finds "name": in a flat JSON object and returns the text of its value.
+static std::string jsonField(const std::string &line, const char *name) {
+    std::string pattern = std::string("\"") + name + "\":";
+    size_t pos = line.find(pattern);
+    if (pos == std::string::npos) return "";
+    pos += pattern.size();
+    if (line[pos] == '"') {
+        size_t end = line.find('"', pos + 1);
+        return line.substr(pos + 1, end - pos - 1);
+    }
+    size_t end = line.find_first_of(",}", pos);
+    return line.substr(pos, end - pos);
+}
+
+static bool parseSample(const std::string &line, Sample &s) {
+    std::string name = jsonField(line, "bench");
+    if (name.empty() || jsonField(line, "ns_per_op").empty()) return false; // not a result line
+    s.key = name + " " + jsonField(line, "board_w") + "x" + jsonField(line, "board_h") + " len " +
+            jsonField(line, "length");
+    s.line = line;
+    s.nsPerOp = std::atof(jsonField(line, "ns_per_op").c_str());
+    s.p99Ns = std::atof(jsonField(line, "p99_ns").c_str());
+    return true;
+}
+
+static std::vector<Sample> readSamples(const char *path) {
+    std::vector<Sample> samples;
+    FILE *f = std::fopen(path, "r");
+    if (!f) {
+        std::fprintf(stderr, "benchcmp: cannot open %s\n", path);
+        std::exit(2);
+    }
+    char buf[1024];
+    Sample s;
+    while (std::fgets(buf, sizeof buf, f))
+        if (parseSample(buf, s)) samples.push_back(s);
+    std::fclose(f);
+    return samples;
+}
+
+static std::vector<Sample> runBench(const std::string &command, int runs) {
+    std::vector<Sample> samples;
+    for (int run = 0; run < runs; ++run) {
+        std::fprintf(stderr, "benchcmp: run %d/%d\n", run + 1, runs);
+        FILE *p = popen(command.c_str(), "r");
+        if (!p) {
+            std::fprintf(stderr, "benchcmp: cannot run %s\n", command.c_str());
+            std::exit(2);
+        }
+        char buf[1024];
+        Sample s;
+        while (std::fgets(buf, sizeof buf, p)) {
+            std::string line = buf;
+            if (!parseSample(line, s)) continue;
+            // Tag the line with its run index before it is stored.
+            size_t brace = line.rfind('}');
+            s.line = line.substr(0, brace) + ",\"run\":" + std::to_string(run) + "}\n";
+            samples.push_back(s);
+        }
+        if (pclose(p) != 0) {
+            std::fprintf(stderr, "benchcmp: bench failed\n");
+            std::exit(2);
+        }
+    }
+    return samples;
+}
+
+static double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    size_t n = v.size();
+    return n % 2 ? v[n / 2] : 0.5 * (v[n / 2 - 1] + v[n / 2]);
+}
+
+// One-sided p-value for "b tends to be larger than a", using the normal
+// approximation with tie and continuity corrections.
+static double mannWhitneyGreater(const std::vector<double> &a, const std::vector<double> &b) {
+    std::vector<std::pair<double, int>> all;
+    for (double x : a) all.push_back({x, 0});
+    for (double x : b) all.push_back({x, 1});
+    std::sort(all.begin(), all.end());
+
+    double n1 = a.size(), n2 = b.size(), n = n1 + n2;
+    double rankSumB = 0.0, tieTerm = 0.0;
+    for (size_t i = 0; i < all.size();) {
+        size_t j = i;
+        while (j < all.size() && all[j].first == all[i].first) ++j;
+        double rank = 0.5 * (i + 1 + j); // average of ranks i+1..j
+        for (size_t k = i; k < j; ++k)
+            if (all[k].second == 1) rankSumB += rank;
+        double t = j - i;
+        tieTerm += t * t * t - t;
+        i = j;
+    }
+
+    double u = rankSumB - n2 * (n2 + 1) / 2;
+    double mean = n1 * n2 / 2;
+    double var = n1 * n2 / 12 * ((n + 1) - tieTerm / (n * (n - 1)));
+    if (var <= 0) return 1.0;
+    double z = (u - mean - 0.5) / std::sqrt(var);
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+static int compare(const std::vector<Sample> &base, const std::vector<Sample> &now, double threshold, double alpha) {
+    std::map<std::string, std::vector<const Sample *>> baseByKey, nowByKey;
+    for (const auto &s : base) baseByKey[s.key].push_back(&s);
+    for (const auto &s : now) nowByKey[s.key].push_back(&s);
+
+    int regressions = 0;
+    std::printf("%-34s %-6s %12s %12s %8s %8s\n", "benchmark", "metric", "base", "new", "delta", "p");
+    for (const auto &entry : nowByKey) {
+        auto it = baseByKey.find(entry.first);
+        if (it == baseByKey.end()) {
+            std::printf("%-34s (not in baseline)\n", entry.first.c_str());
+            continue;
+        }
+        for (int metric = 0; metric < 2; ++metric) {
+            std::vector<double> a, b;
+            for (const Sample *s : it->second) a.push_back(metric ? s->p99Ns : s->nsPerOp);
+            for (const Sample *s : entry.second) b.push_back(metric ? s->p99Ns : s->nsPerOp);
+
+            double ma = median(a), mb = median(b);
+            double delta = ma > 0 ? (mb - ma) / ma * 100 : 0;
+            double p = mannWhitneyGreater(a, b);
+            bool regressed = delta > threshold && p < alpha;
+            regressions += regressed;
+            std::printf("%-34s %-6s %12.1f %12.1f %+7.1f%% %8.4f%s\n", entry.first.c_str(), metric ? "p99" : "ns/op",
+                        ma, mb, delta, p, regressed ? "  REGRESSED" : "");
+        }
+    }
+
+    if (regressions)
+        std::printf("\n%d metric(s) regressed by more than %.1f%% (p < %.3f)\n", regressions, threshold, alpha);
+    else
+        std::printf("\nno regressions\n");
+    return regressions ? 1 : 0;
+}
+
+[[noreturn]] static void usage() {
+    std::fprintf(stderr,
+                 "usage: benchcmp record BASELINE.jsonl [--runs N] [--bench PATH] [-- BENCH ARGS]\n"
+                 "       benchcmp compare BASELINE.jsonl [NEW.jsonl] [--runs N] [--bench PATH]\n"
+                 "                        [--threshold PERCENT] [--alpha P] [-- BENCH ARGS]\n");
+    std::exit(2);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3) usage();
+    std::string mode = argv[1];
+    const char *baselinePath = argv[2];
+    const char *newPath = nullptr;
+    std::string bench = "./bench";
+    std::string benchArgs;
+    int runs = 7;
+    double threshold = 5.0, alpha = 0.05;
+
+    for (int i = 3; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--runs") && i + 1 < argc) {
+            runs = std::atoi(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--bench") && i + 1 < argc) {
+            bench = argv[++i];
+        } else if (!std::strcmp(argv[i], "--threshold") && i + 1 < argc) {
+            threshold = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--alpha") && i + 1 < argc) {
+            alpha = std::atof(argv[++i]);
+        } else if (!std::strcmp(argv[i], "--")) {
+            for (++i; i < argc; ++i) benchArgs += std::string(" ") + argv[i];
+        } else if (mode == "compare" && !newPath && argv[i][0] != '-') {
+            newPath = argv[i];
+        } else {
+            usage();
+        }
+    }
+    if (runs < 2) runs = 2;
+    std::string command = bench + " --json" + benchArgs;
+
+    if (mode == "record") {
+        std::vector<Sample> samples = runBench(command, runs);
+        FILE *f = std::fopen(baselinePath, "w");
+        if (!f) {
+            std::fprintf(stderr, "benchcmp: cannot write %s\n", baselinePath);
+            return 2;
+        }
+        for (const auto &s : samples) std::fputs(s.line.c_str(), f);
+        std::fclose(f);
+        std::fprintf(stderr, "benchcmp: wrote %zu results to %s\n", samples.size(), baselinePath);
+        return 0;
+    }
+    if (mode == "compare") {
+        std::vector<Sample> base = readSamples(baselinePath);
+        std::vector<Sample> now = newPath ? readSamples(newPath) : runBench(command, runs);
+        return compare(base, now, threshold, alpha);
+    }
+    usage();
+}
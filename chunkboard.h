@@ -0,0 +1,83 @@
+// Tile storage for boards much larger than the window.
+//
+// The board is split into CHUNK x CHUNK tile chunks that are only allocated
+// once something is written into them, so an 8192x8192 board with sparse
+// walls costs memory only where the walls and the snake are. Each chunk
+// keeps a count of its non-empty tiles so renderers can skip empty chunks
+// without looking at their tiles.
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+enum Tile : uint8_t { EMPTY, WALL, SNAKE, FOOD };
+
+// Told about every tile that changes value, e.g. to keep a minimap current.
+struct TileObserver {
+    virtual void tileChanged(int x, int y, Tile from, Tile to) = 0;
+
+protected:
+    ~TileObserver() = default;
+};
+
+class ChunkedBoard {
+public:
+    static const int CHUNK_SHIFT = 6;
+    static const int CHUNK = 1 << CHUNK_SHIFT; // 64 tiles per side
+
+    struct Chunk {
+        uint8_t tiles[CHUNK * CHUNK];
+        int nonEmpty;
+    };
+
+    ChunkedBoard(int widthTiles, int heightTiles)
+        : w(widthTiles), h(heightTiles), chunksX((w + CHUNK - 1) >> CHUNK_SHIFT),
+          chunksY((h + CHUNK - 1) >> CHUNK_SHIFT), chunks(chunksX * chunksY) {}
+
+    int width() const { return w; }
+    int height() const { return h; }
+    int chunkColumns() const { return chunksX; }
+    int chunkRows() const { return chunksY; }
+
+    bool inside(int x, int y) const { return x >= 0 && y >= 0 && x < w && y < h; }
+
+    Tile get(int x, int y) const {
+        const Chunk* c = chunks[(y >> CHUNK_SHIFT) * chunksX + (x >> CHUNK_SHIFT)].get();
+        return c ? Tile(c->tiles[(y & (CHUNK - 1)) * CHUNK + (x & (CHUNK - 1))]) : EMPTY;
+    }
+
+    void set(int x, int y, Tile t) {
+        auto& slot = chunks[(y >> CHUNK_SHIFT) * chunksX + (x >> CHUNK_SHIFT)];
+        if (!slot) {
+            if (t == EMPTY) return;
+            slot.reset(new Chunk);
+            std::memset(slot->tiles, EMPTY, sizeof slot->tiles);
+            slot->nonEmpty = 0;
+        }
+        uint8_t& tile = slot->tiles[(y & (CHUNK - 1)) * CHUNK + (x & (CHUNK - 1))];
+        if (tile == t) return;
+        slot->nonEmpty += (t != EMPTY) - (tile != EMPTY);
+        if (observer) observer->tileChanged(x, y, Tile(tile), t);
+        tile = t;
+    }
+
+    // At most one observer; pass nullptr to stop.
+    void observe(TileObserver* o) { observer = o; }
+
+    // Null when nothing was ever written to the chunk.
+    const Chunk* chunk(int cx, int cy) const { return chunks[cy * chunksX + cx].get(); }
+
+    size_t allocatedChunks() const {
+        size_t n = 0;
+        for (const auto& c : chunks) n += c != nullptr;
+        return n;
+    }
+
+private:
+    int w, h;
+    int chunksX, chunksY;
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    TileObserver* observer = nullptr;
+};
@@ -0,0 +1,179 @@
+// Always-on capture of the last few seconds of play, saved as a GIF or APNG
+// clip on request.
+//
+// ClipRecorder keeps replay records (replay.h) rather than pixels, a few
+// bytes per tick. They are grouped in segments that each start with a
+// keyframe, and the oldest segment is reused once the newer ones cover the
+// requested time, so after the first lap recording does not allocate.
+// ClipExporter renders a snapshot of the ring with the software rasterizer
+// and encodes it on its own thread, so saving never holds up a frame.
+#pragma once
+
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "imageio.h"
+#include "replay.h"
+#include "softraster.h"
+
+class ClipRecorder {
+public:
+    static const int KEYFRAME_INTERVAL = 64;
+
+    ClipRecorder(int width, int height, int tileSize, int fps, int seconds)
+        : width(width), height(height), tileSize(tileSize), fps(fps), wanted(size_t(seconds) * fps),
+          segments((wanted + KEYFRAME_INTERVAL - 1) / KEYFRAME_INTERVAL + 1) {}
+
+    void frame(const ReplayState &s) {
+        bool keyframe = encoder.frameCount() % KEYFRAME_INTERVAL == 0;
+        if (keyframe) {
+            current = (current + 1) % segments.size();
+            segments[current].bytes.clear();
+            segments[current].frames = 0;
+            if (used < segments.size()) used++;
+        }
+        encoder.encode(segments[current].bytes, s, keyframe);
+        segments[current].frames++;
+    }
+
+    // A replay of at least the last `seconds` (when recorded), starting at a
+    // keyframe. Frames before the last framesWanted() are only there to
+    // reach that keyframe.
+    std::vector<uint8_t> snapshot() const {
+        size_t count = 0, frames = 0;
+        while (count < used && frames < wanted) frames += segments[(current + segments.size() - count++) % segments.size()].frames;
+
+        std::vector<uint8_t> out;
+        replayformat::putHeader(out, width, height, tileSize, fps, KEYFRAME_INTERVAL);
+        for (size_t i = count; i-- > 0;) {
+            const std::vector<uint8_t> &bytes = segments[(current + segments.size() - i) % segments.size()].bytes;
+            out.insert(out.end(), bytes.begin(), bytes.end());
+        }
+        return out;
+    }
+
+    size_t framesWanted() const { return wanted; }
+
+    // Bytes held by the ring, for the curious.
+    size_t memoryBytes() const {
+        size_t n = 0;
+        for (const Segment &s : segments) n += s.bytes.capacity();
+        return n;
+    }
+
+private:
+    struct Segment {
+        std::vector<uint8_t> bytes;
+        size_t frames = 0;
+    };
+
+    int width, height, tileSize, fps;
+    size_t wanted;
+    ReplayEncoder encoder;
+    std::vector<Segment> segments;
+    size_t current = 0; // segment being written; the first frame moves to 1
+    size_t used = 0;
+};
+
+class ClipExporter {
+public:
+    // Draws a recorded state into an INDEXED8 framebuffer. Runs on the
+    // exporter thread, so it must only touch state of its own (e.g. its own
+    // font and ScoreLabel).
+    using DrawFn = std::function<void(SoftFramebuffer &, const ReplayState &)>;
+
+    explicit ClipExporter(DrawFn draw) : draw(std::move(draw)), thread([this] { run(); }) {}
+
+    ~ClipExporter() { stop(); }
+
+    // Finishes the queued clip, if any, and ends the thread. Call it before
+    // freeing what the draw function uses.
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        if (thread.joinable()) thread.join();
+    }
+
+    // Queues the last maxFrames frames of a ClipRecorder snapshot. Returns
+    // false when a clip is already waiting, so mashing the key does not pile
+    // up work.
+    bool submit(std::vector<uint8_t> replay, size_t maxFrames, AnimationEncoder::Format format, std::string path) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (queued || stopping) return false;
+            job = {std::move(replay), maxFrames, format, std::move(path)};
+            queued = true;
+        }
+        wake.notify_one();
+        return true;
+    }
+
+private:
+    struct Job {
+        std::vector<uint8_t> replay;
+        size_t maxFrames;
+        AnimationEncoder::Format format;
+        std::string path;
+    };
+
+    void run() {
+        for (;;) {
+            Job next;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return queued || stopping; });
+                if (!queued) return;
+                next = std::move(job);
+                queued = false;
+            }
+            encode(next);
+        }
+    }
+
+    // Two passes over the frames: the first settles the palette, which GIF
+    // and APNG need before the first frame; the second encodes.
+    void encode(Job &j) {
+        Replay replay;
+        if (!replay.parse(std::move(j.replay)) || replay.frames == 0) return;
+        size_t skip = replay.frames > j.maxFrames ? replay.frames - j.maxFrames : 0;
+
+        SoftFramebuffer frame(replay.width, replay.height, SoftFramebuffer::INDEXED8);
+        ReplayState state;
+        for (const Replay::Segment &segment : replay.segments) {
+            Replay::Reader reader(replay, segment);
+            while (reader.next(state)) draw(frame, state);
+        }
+
+        AnimationEncoder encoder(j.format, replay.width, replay.height, frame.palette(), 1000 / replay.fps);
+        size_t index = 0;
+        for (const Replay::Segment &segment : replay.segments) {
+            Replay::Reader reader(replay, segment);
+            while (reader.next(state)) {
+                if (index++ < skip) continue;
+                draw(frame, state);
+                encoder.addFrame(frame.row(0), frame.pitch());
+            }
+        }
+
+        std::vector<uint8_t> file = encoder.finish();
+        if (writeFile(j.path.c_str(), file))
+            std::printf("Saved %zu-frame clip to %s (%zu KB)\n", replay.frames - skip, j.path.c_str(), file.size() / 1024);
+        else
+            std::fprintf(stderr, "Cannot write clip %s\n", j.path.c_str());
+    }
+
+    DrawFn draw;
+    std::mutex mutex;
+    std::condition_variable wake;
+    Job job;
+    bool queued = false;
+    bool stopping = false;
+    std::thread thread; // last, so it starts after everything it uses
+};
@@ -0,0 +1,320 @@
+// Reachability on packed row bitsets: how many tiles can be reached from a
+// tile through open ones, which bots and the trapped check ask every tick.
+//
+// A BitGrid keeps one bit per tile in rows of 64-bit words, with a zero word
+// at each end of a row and a zero row above and below the board, so a row's
+// neighbours are read without edge checks.
+//
+// FloodFill grows the reached set a row at a time, sweeping down the board
+// and back up. Each row takes in the reached tiles above and below it and
+// then spreads along its open runs: an add carries the fill up a run and
+// shifts carry it down. One sweep follows a path for as long as it keeps
+// heading the same way vertically. Sweeps repeat until one changes nothing
+// and only cover the rows reached so far, plus one on each side. With a
+// target, the fill stops at the first row where it reaches a target tile.
+//
+// Rows of four words or more (256 tiles) go four words at a time with AVX2
+// when the CPU has it.
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "level.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FLOODFILL_X86 1
+#endif
+
+class BitGrid {
+public:
+    BitGrid() = default;
+    BitGrid(int cols, int rows) { resize(cols, rows); }
+
+    // Clears every bit.
+    void resize(int cols, int rows) {
+        c = cols;
+        r = rows;
+        words = size_t(cols + 63) / 64;
+        stride = words + 2;
+        bits.assign(stride * (size_t(rows) + 2), 0);
+    }
+    void clear() { std::fill(bits.begin(), bits.end(), 0); }
+
+    // Set where a level has no wall.
+    void openTilesOf(const Level &level) {
+        resize(level.cols(), level.rows());
+        uint64_t last = c % 64 ? (uint64_t(1) << (c % 64)) - 1 : ~uint64_t(0);
+        for (int y = 0; y < r; ++y) {
+            const uint64_t *walls = level.wallRow(y);
+            uint64_t *out = row(y);
+            for (size_t k = 0; k < words; ++k) out[k] = ~walls[k];
+            out[words - 1] &= last;
+        }
+    }
+
+    int cols() const { return c; }
+    int rows() const { return r; }
+    size_t wordsPerRow() const { return words; }
+
+    bool get(int x, int y) const { return row(y)[x >> 6] >> (x & 63) & 1; }
+    void set(int x, int y) { row(y)[x >> 6] |= uint64_t(1) << (x & 63); }
+    void reset(int x, int y) { row(y)[x >> 6] &= ~(uint64_t(1) << (x & 63)); }
+
+    // Row y's words; y may be -1 or rows, which are always zero.
+    uint64_t *row(int y) { return bits.data() + (size_t(y) + 1) * stride + 1; }
+    const uint64_t *row(int y) const { return bits.data() + (size_t(y) + 1) * stride + 1; }
+
+private:
+    int c = 0, r = 0;
+    size_t words = 0, stride = 0;
+    std::vector<uint64_t> bits;
+};
+
+struct FloodResult {
+    size_t tiles = 0;           // reached, or reached so far when the target stopped the fill
+    bool reachedTarget = false;
+    int sweeps = 0;
+};
+
+namespace floodfill {
+
+// Sets every bit of m above a set bit of g along the same run of m; g is
+// within m.
+inline uint64_t fillUp(uint64_t g, uint64_t m) { return (((g + m) ^ m) & m) | g; }
+
+// The same downwards, doubling the reach each step.
+inline uint64_t fillDown(uint64_t g, uint64_t m) {
+    g |= m & (g >> 1);
+    uint64_t p = m & (m >> 1);
+    g |= p & (g >> 2);
+    p &= p >> 2;
+    g |= p & (g >> 4);
+    p &= p >> 4;
+    g |= p & (g >> 8);
+    p &= p >> 8;
+    g |= p & (g >> 16);
+    p &= p >> 16;
+    return g | (p & (g >> 32));
+}
+
+// Carry the fill across word boundaries. A scalar spread goes up the row in
+// order and so only needs carryDown().
+inline void carryDown(uint64_t *r, const uint64_t *open, size_t n) {
+    for (size_t k = n - 1; k-- > 0;)
+        if (r[k + 1] & open[k] >> 63 & ~r[k] >> 63 & 1) r[k] = fillDown(r[k] | uint64_t(1) << 63, open[k]);
+}
+
+inline void carryUp(uint64_t *r, const uint64_t *open, size_t n) {
+    for (size_t k = 1; k < n; ++k)
+        if (r[k - 1] >> 63 & open[k] & ~r[k] & 1) r[k] = fillUp(r[k] | 1, open[k]);
+}
+
+// One row: takes in the reached tiles above and below, then spreads along the
+// open runs. Returns whether the row changed.
+inline bool spreadRowScalar(uint64_t *r, const uint64_t *above, const uint64_t *below, const uint64_t *open, size_t n) {
+    uint64_t changed = 0;
+    for (size_t k = 0; k < n; ++k) {
+        uint64_t cur = r[k];
+        uint64_t g = (cur | cur << 1 | cur >> 1 | r[k - 1] >> 63 | r[k + 1] << 63 | above[k] | below[k]) & open[k];
+        g = fillDown(fillUp(g, open[k]), open[k]);
+        changed |= g ^ cur;
+        r[k] = g;
+    }
+    if (!changed) return false;
+    carryDown(r, open, n);
+    return true;
+}
+
+#ifdef FLOODFILL_X86
+__attribute__((target("avx2"))) inline __m256i fillUpAvx2(__m256i g, __m256i m) {
+    return _mm256_or_si256(_mm256_and_si256(_mm256_xor_si256(_mm256_add_epi64(g, m), m), m), g);
+}
+
+__attribute__((target("avx2"))) inline __m256i fillDownAvx2(__m256i g, __m256i m) {
+    g = _mm256_or_si256(g, _mm256_and_si256(m, _mm256_srli_epi64(g, 1)));
+    __m256i p = _mm256_and_si256(m, _mm256_srli_epi64(m, 1));
+    g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, 2)));
+    p = _mm256_and_si256(p, _mm256_srli_epi64(p, 2));
+    g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, 4)));
+    p = _mm256_and_si256(p, _mm256_srli_epi64(p, 4));
+    g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, 8)));
+    p = _mm256_and_si256(p, _mm256_srli_epi64(p, 8));
+    g = _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, 16)));
+    p = _mm256_and_si256(p, _mm256_srli_epi64(p, 16));
+    return _mm256_or_si256(g, _mm256_and_si256(p, _mm256_srli_epi64(g, 32)));
+}
+
+// Four words at a time; the words of one vector see each other's old
+// values, so carries go across in separate passes afterwards.
+__attribute__((target("avx2"))) inline bool spreadRowAvx2(uint64_t *r, const uint64_t *above, const uint64_t *below,
+                                                          const uint64_t *open, size_t n) {
+    __m256i changed = _mm256_setzero_si256();
+    size_t k = 0;
+    for (; k + 4 <= n; k += 4) {
+        __m256i cur = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(r + k));
+        __m256i left = _mm256_srli_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(r + k - 1)), 63);
+        __m256i right = _mm256_slli_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(r + k + 1)), 63);
+        __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(open + k));
+        __m256i g = _mm256_or_si256(_mm256_or_si256(cur, _mm256_slli_epi64(cur, 1)), _mm256_srli_epi64(cur, 1));
+        g = _mm256_or_si256(g, _mm256_or_si256(left, right));
+        g = _mm256_or_si256(g, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(above + k)));
+        g = _mm256_or_si256(g, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(below + k)));
+        g = fillDownAvx2(fillUpAvx2(_mm256_and_si256(g, m), m), m);
+        changed = _mm256_or_si256(changed, _mm256_xor_si256(g, cur));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(r + k), g);
+    }
+    uint64_t tail = 0;
+    for (; k < n; ++k) {
+        uint64_t cur = r[k];
+        uint64_t g = (cur | cur << 1 | cur >> 1 | r[k - 1] >> 63 | r[k + 1] << 63 | above[k] | below[k]) & open[k];
+        g = fillDown(fillUp(g, open[k]), open[k]);
+        tail |= g ^ cur;
+        r[k] = g;
+    }
+    if (_mm256_testz_si256(changed, changed) && !tail) return false;
+    carryUp(r, open, n);
+    carryDown(r, open, n);
+    return true;
+}
+#endif
+
+} // namespace floodfill
+
+class FloodFill {
+public:
+    FloodFill() {
+#ifdef FLOODFILL_X86
+        avx2 = SDL_HasAVX2();
+#endif
+    }
+
+    // Off to compare against the scalar rows; ignored without AVX2.
+    void useAvx2(bool on) {
+#ifdef FLOODFILL_X86
+        avx2 = on && SDL_HasAVX2();
+#else
+        (void)on;
+#endif
+    }
+
+    // The open tiles reachable from (x, y), which need not be open itself
+    // (a snake's head is not). With a target, stops once a target tile is
+    // reached; tiles then counts only what was reached up to that point.
+    FloodResult fill(const BitGrid &open, int x, int y, const BitGrid *target = nullptr) {
+        FloodResult result;
+        if (reach.cols() != open.cols() || reach.rows() != open.rows()) {
+            reach.resize(open.cols(), open.rows());
+        } else {
+            for (int row = top; row <= bottom; ++row) std::fill_n(reach.row(row), reach.wordsPerRow(), 0);
+        }
+        top = open.rows();
+        bottom = -1;
+
+        static const int SEEDS[5][2] = {{0, 0}, {1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+        for (const int *d : SEEDS) {
+            int sx = x + d[0], sy = y + d[1];
+            if (unsigned(sx) >= unsigned(open.cols()) || unsigned(sy) >= unsigned(open.rows()) || !open.get(sx, sy)) continue;
+            reach.set(sx, sy);
+            top = std::min(top, sy);
+            bottom = std::max(bottom, sy);
+            if (target && target->get(sx, sy)) result.reachedTarget = true;
+        }
+        if (bottom < 0) {
+            top = 0; // nothing to clear next time
+            return result;
+        }
+
+        const size_t n = open.wordsPerRow();
+        auto spread = [&](int row) {
+            bool changed;
+#ifdef FLOODFILL_X86
+            if (avx2 && n >= 4)
+                changed = floodfill::spreadRowAvx2(reach.row(row), reach.row(row - 1), reach.row(row + 1), open.row(row), n);
+            else
+#endif
+                changed = floodfill::spreadRowScalar(reach.row(row), reach.row(row - 1), reach.row(row + 1), open.row(row), n);
+            if (!changed) return false;
+            top = std::min(top, row);
+            bottom = std::max(bottom, row);
+            if (target) {
+                const uint64_t *r = reach.row(row), *t = target->row(row);
+                for (size_t k = 0; k < n; ++k) result.reachedTarget |= (r[k] & t[k]) != 0;
+            }
+            return true;
+        };
+
+        const int last = open.rows() - 1;
+        while (!result.reachedTarget) {
+            bool changed = false;
+            result.sweeps++;
+            if (result.sweeps % 2) {
+                for (int row = std::max(top - 1, 0); row <= std::min(bottom + 1, last) && !result.reachedTarget; ++row)
+                    changed |= spread(row);
+            } else {
+                for (int row = std::min(bottom + 1, last); row >= std::max(top - 1, 0) && !result.reachedTarget; --row)
+                    changed |= spread(row);
+            }
+            if (!changed) break;
+        }
+
+        for (int row = top; row <= bottom; ++row) {
+            const uint64_t *r = reach.row(row);
+            for (size_t k = 0; k < n; ++k) result.tiles += size_t(__builtin_popcountll(r[k]));
+        }
+        return result;
+    }
+
+    // The tiles the last fill reached.
+    const BitGrid &reached() const { return reach; }
+
+private:
+    BitGrid reach;
+    int top = 0, bottom = -1; // rows the last fill reached
+    bool avx2 = false;
+};
+
+// The same on one byte per tile with a queue, as the bitset fill is checked
+// and measured against.
+class QueueFloodFill {
+public:
+    FloodResult fill(const std::vector<uint8_t> &open, int cols, int rows, int x, int y,
+                     const std::vector<uint8_t> *target = nullptr) {
+        FloodResult result;
+        if (seen.size() == open.size()) {
+            for (uint32_t i : queue) seen[i] = 0; // only what the last fill marked
+        } else {
+            seen.assign(open.size(), 0);
+        }
+        queue.clear();
+        auto visit = [&](int tx, int ty) {
+            if (unsigned(tx) >= unsigned(cols) || unsigned(ty) >= unsigned(rows)) return;
+            uint32_t i = uint32_t(ty) * uint32_t(cols) + uint32_t(tx);
+            if (!open[i] || seen[i]) return;
+            seen[i] = 1;
+            queue.push_back(i);
+            result.reachedTarget |= target && (*target)[i];
+        };
+        visit(x, y);
+        visit(x + 1, y);
+        visit(x - 1, y);
+        visit(x, y + 1);
+        visit(x, y - 1);
+        for (size_t head = 0; head < queue.size() && !result.reachedTarget; ++head) {
+            int tx = int(queue[head] % uint32_t(cols)), ty = int(queue[head] / uint32_t(cols));
+            visit(tx + 1, ty);
+            visit(tx - 1, ty);
+            visit(tx, ty + 1);
+            visit(tx, ty - 1);
+        }
+        result.tiles = queue.size();
+        return result;
+    }
+
+private:
+    std::vector<uint8_t> seen;
+    std::vector<uint32_t> queue;
+};
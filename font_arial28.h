@@ -0,0 +1,93 @@
+// Generated by `fontbake arial.ttf 28 arial28 font_arial28.h`; do not edit.
+// 27 glyphs in a 307x20 strip, 780 bytes.
+#pragma once
+
+#include "bakedfont.h"
+
+namespace bakedfonts {
+
+const uint8_t arial28Bits[] = {
+    0x87, 0x0f, 0x40, 0xf8, 0x01, 0x1f, 0x00, 0x1c, 0xfe, 0x0f, 0x3e, 0xfe, 0x3f, 0x7c, 0x80, 0x0f,
+    0xff, 0xff, 0x80, 0x3f, 0x00, 0xfc, 0x00, 0xf0, 0x03, 0xf8, 0x01, 0x1f, 0xe0, 0xc7, 0xcf, 0x87,
+    0xc7, 0x7c, 0xc0, 0x0f, 0xfb, 0x01, 0x06, 0xc7, 0x3f, 0x60, 0xfe, 0xc3, 0x7f, 0x00, 0x1e, 0xfe,
+    0x8f, 0x7f, 0xfe, 0x3f, 0xff, 0xe1, 0x3f, 0xff, 0xff, 0xe0, 0xff, 0x00, 0xff, 0x03, 0xfc, 0x0f,
+    0xfe, 0xc7, 0x7f, 0xf8, 0xcf, 0xef, 0xef, 0xdf, 0xfe, 0xf1, 0x1f, 0xff, 0x01, 0x06, 0xe7, 0x78,
+    0x70, 0x0f, 0xc7, 0xf1, 0x00, 0x1e, 0x06, 0xc0, 0xe1, 0x00, 0x38, 0x87, 0xf3, 0x70, 0x1f, 0x00,
+    0xf8, 0xe0, 0xc1, 0x03, 0x0f, 0x1e, 0x1e, 0x07, 0xe7, 0xe1, 0x3c, 0xdc, 0x3f, 0x7c, 0xdc, 0xc3,
+    0x79, 0x38, 0x8f, 0x03, 0x07, 0x77, 0x70, 0x78, 0x07, 0xee, 0xe0, 0x00, 0x1f, 0x06, 0xe0, 0xc0,
+    0x01, 0x9c, 0x03, 0x73, 0x60, 0x1c, 0x00, 0x38, 0x80, 0xe3, 0x01, 0x1e, 0x07, 0x38, 0x03, 0xee,
+    0xc0, 0x1c, 0x38, 0x1f, 0x3c, 0xd8, 0x81, 0x3b, 0x70, 0x07, 0x03, 0x03, 0x37, 0x60, 0xfe, 0x03,
+    0x6e, 0xc0, 0x80, 0x1f, 0x06, 0x60, 0xc0, 0x01, 0x8e, 0x01, 0x3b, 0xe0, 0x1c, 0x00, 0x1c, 0x00,
+    0xe3, 0x00, 0x1c, 0x07, 0xb0, 0x03, 0x7e, 0xc0, 0x0e, 0x30, 0x1f, 0x1c, 0xd8, 0x81, 0x1f, 0x70,
+    0x07, 0x07, 0x03, 0x37, 0xe0, 0xe7, 0x03, 0x7c, 0xc0, 0x80, 0x1d, 0x07, 0x60, 0x00, 0x00, 0x8e,
+    0x01, 0x3f, 0xc0, 0x1c, 0x00, 0x0e, 0x00, 0x73, 0x00, 0x38, 0x07, 0x70, 0x00, 0x7e, 0x00, 0x0e,
+    0xf0, 0x0f, 0x1c, 0xf8, 0x80, 0x1f, 0x60, 0x03, 0x87, 0x03, 0x3e, 0xe0, 0x61, 0x00, 0x0e, 0xe0,
+    0xc0, 0x1c, 0xf7, 0x71, 0x00, 0x00, 0x87, 0x03, 0x3b, 0xc0, 0x1c, 0x00, 0x0e, 0x00, 0x70, 0x00,
+    0x38, 0x07, 0x00, 0x80, 0x7f, 0x00, 0xfe, 0xff, 0x0f, 0x1c, 0xf8, 0x80, 0x0f, 0xe0, 0x03, 0x86,
+    0x01, 0x3e, 0xc0, 0x60, 0x00, 0x0e, 0x70, 0xe0, 0x1c, 0xff, 0x73, 0x3e, 0x00, 0x03, 0x87, 0x3b,
+    0xc0, 0x1c, 0x00, 0x06, 0x00, 0x30, 0x00, 0x38, 0x1e, 0x00, 0xfc, 0x7f, 0x00, 0xfe, 0xff, 0x0f,
+    0x1c, 0xf8, 0x80, 0x0f, 0xe0, 0x03, 0x8e, 0x01, 0x3e, 0xc0, 0x60, 0x00, 0x07, 0x3e, 0x60, 0x1c,
+    0x0f, 0xf7, 0x7f, 0x80, 0x03, 0xfe, 0x38, 0xe0, 0x1c, 0x00, 0x06, 0x00, 0x38, 0x00, 0x30, 0xfe,
+    0x00, 0x7f, 0x7e, 0x00, 0x0e, 0xc0, 0x0f, 0x1c, 0xf8, 0x80, 0x0f, 0x60, 0x03, 0xce, 0x01, 0x3e,
+    0xc0, 0x60, 0x80, 0x07, 0x7e, 0x30, 0x1c, 0x03, 0xfe, 0xe1, 0x80, 0x01, 0xfe, 0x71, 0xe0, 0xfc,
+    0x3f, 0x07, 0x00, 0x38, 0x00, 0x30, 0xf8, 0x8f, 0x07, 0x7e, 0xc0, 0x0f, 0xc0, 0x0f, 0x1c, 0xf8,
+    0x80, 0x1f, 0x60, 0x03, 0xcc, 0x00, 0x3e, 0xc0, 0x60, 0xc0, 0x03, 0xe0, 0x38, 0x1c, 0x00, 0xfe,
+    0xc0, 0xc1, 0x81, 0x87, 0xf3, 0xf0, 0xfc, 0x3f, 0x07, 0xf8, 0x3f, 0x00, 0x70, 0xc0, 0x9f, 0x03,
+    0x7e, 0xc0, 0x0e, 0xc0, 0x0f, 0x1c, 0xf8, 0x80, 0x1f, 0x70, 0x03, 0xfc, 0x00, 0x3e, 0xc0, 0x60,
+    0xe0, 0x01, 0xc0, 0x1d, 0x1c, 0x00, 0x7c, 0xc0, 0xc1, 0x81, 0x01, 0xe7, 0xdf, 0x1c, 0x00, 0x06,
+    0xf8, 0x3f, 0x00, 0x30, 0x00, 0xbe, 0x03, 0xef, 0xe0, 0x1c, 0xf8, 0x0f, 0x1c, 0xf8, 0x80, 0x3b,
+    0x70, 0x03, 0x78, 0x00, 0x3e, 0xc0, 0x60, 0xf0, 0x00, 0xc0, 0x0d, 0x1c, 0x00, 0x7c, 0x80, 0xc1,
+    0xc0, 0x01, 0x86, 0xcf, 0x1f, 0x00, 0x06, 0x00, 0x37, 0x00, 0x30, 0x00, 0xf0, 0x87, 0xef, 0xf1,
+    0x3c, 0xfc, 0x0f, 0x1c, 0xf8, 0x80, 0x7b, 0x38, 0x03, 0x78, 0x00, 0x3e, 0xe0, 0x60, 0x78, 0x00,
+    0x80, 0xff, 0x7f, 0x00, 0x7c, 0x80, 0xe1, 0xc0, 0x01, 0x06, 0xc0, 0x1f, 0x00, 0x0e, 0x00, 0x77,
+    0x00, 0xb8, 0x03, 0x70, 0xff, 0xcf, 0x7f, 0xf8, 0xdf, 0x0f, 0x1c, 0xf8, 0x80, 0xf3, 0x1f, 0x03,
+    0x78, 0x00, 0x36, 0xe0, 0x60, 0x1c, 0x70, 0x80, 0xff, 0xff, 0x03, 0x7c, 0x80, 0xe1, 0xc0, 0x01,
+    0x06, 0xe0, 0x1f, 0x00, 0x0e, 0x00, 0x77, 0x00, 0xb8, 0x03, 0x60, 0x7e, 0x0c, 0x1f, 0xe0, 0xc7,
+    0x0f, 0x1c, 0xf8, 0x80, 0xc3, 0x07, 0x03, 0x30, 0x00, 0x30, 0xe0, 0x60, 0x0e, 0x70, 0xc0, 0x01,
+    0x9c, 0x03, 0x6e, 0xc0, 0x61, 0xc0, 0x01, 0x36, 0x60, 0x1c, 0x00, 0x1c, 0x00, 0xe7, 0x00, 0x1c,
+    0x07, 0x70, 0x00, 0x00, 0x00, 0x00, 0xc0, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x70, 0x70, 0x60, 0x07, 0xe0, 0xc0, 0x01, 0x1c, 0x07, 0xee, 0xc0, 0x61, 0x80, 0x01, 0x37, 0x70,
+    0x1c, 0x00, 0x38, 0x00, 0xe7, 0x01, 0x1e, 0x0f, 0x70, 0x00, 0x00, 0x00, 0x00, 0xc0, 0x03, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xe6, 0x78, 0xe0, 0x03, 0xe0, 0xe1, 0x00, 0x1c, 0x8f,
+    0xc7, 0xe1, 0x70, 0x80, 0x87, 0x73, 0x38, 0x1c, 0x00, 0xf8, 0xe0, 0xc3, 0x03, 0x0f, 0x3e, 0x3e,
+    0x00, 0x00, 0x00, 0x00, 0xc0, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc6, 0x3f,
+    0xe0, 0xff, 0xcf, 0x7f, 0x00, 0x1c, 0xfe, 0x83, 0x7f, 0x70, 0x00, 0xff, 0xe1, 0x1f, 0x1c, 0x00,
+    0xe0, 0xff, 0x01, 0xff, 0x03, 0xfc, 0x1f, 0x00, 0x00, 0x00, 0x00, 0xc0, 0x03, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x86, 0x0f, 0xe0, 0xff, 0x0f, 0x1f, 0x00, 0x1c, 0xf8, 0x00, 0x3f,
+    0x70, 0x00, 0xfc, 0x80, 0x0f, 0x1c, 0x00, 0x80, 0x3f, 0x00, 0xfc, 0x00, 0xf0, 0x07, 0x00, 0x00,
+    0x00, 0x00, 0xc0, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+const BakedGlyph arial28Glyphs[] = {
+    {' ', 0, 0, 0, 0, 0, 8},
+    {'!', 0, 3, 20, 2, 6, 8},
+    {'0', 3, 13, 20, 1, 6, 16},
+    {'1', 16, 7, 20, 3, 6, 16},
+    {'2', 23, 13, 20, 1, 6, 16},
+    {'3', 36, 13, 20, 1, 6, 16},
+    {'4', 49, 14, 20, 0, 6, 16},
+    {'5', 63, 13, 20, 1, 6, 16},
+    {'6', 76, 13, 20, 1, 6, 16},
+    {'7', 89, 13, 20, 1, 6, 16},
+    {'8', 102, 13, 20, 1, 6, 16},
+    {'9', 115, 13, 20, 1, 6, 16},
+    {':', 128, 2, 15, 3, 11, 8},
+    {'F', 130, 14, 20, 2, 6, 17},
+    {'G', 144, 19, 20, 1, 6, 22},
+    {'O', 163, 20, 20, 1, 6, 22},
+    {'S', 183, 16, 20, 1, 6, 19},
+    {'a', 199, 13, 15, 1, 11, 16},
+    {'c', 212, 13, 15, 1, 11, 14},
+    {'e', 225, 13, 15, 1, 11, 16},
+    {'i', 238, 2, 20, 2, 6, 6},
+    {'l', 240, 2, 20, 2, 6, 6},
+    {'m', 242, 20, 15, 2, 11, 23},
+    {'n', 262, 12, 15, 2, 11, 16},
+    {'o', 274, 14, 15, 1, 11, 16},
+    {'r', 288, 7, 15, 2, 11, 9},
+    {'v', 295, 12, 15, 1, 11, 14},
+};
+
+const BakedFontData arial28 = {28, 32, 26, 307, 20, arial28Bits, arial28Glyphs, 27};
+
+} // namespace bakedfonts
@@ -0,0 +1,120 @@
+// Bakes the glyphs of a TrueType font at one size into a header for
+// bakedfont.h, so the program using it needs no font file for that text.
+//
+//   fontbake FONT.ttf SIZE NAME OUT.h [CHARS]
+//
+// Each glyph is rendered with TTF_RenderGlyph_Solid, the way
+// TTF_RenderText_Solid draws it, cropped to its ink and stored at 1 bit per
+// pixel in one strip. CHARS defaults to the text b.cpp draws: "Score: ",
+// "Game Over! Final Score: " and the digits. font_arial28.h was made with
+//
+//   fontbake arial.ttf 28 arial28 font_arial28.h
+//
+// and fontcheck.cpp checks it against the SDL_ttf in use.
+#define SDL_MAIN_HANDLED
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <string>
+#include <vector>
+
+struct Glyph {
+    char ch;
+    int x = 0, w = 0, h = 0, dx = 0, dy = 0, advance = 0;
+    std::vector<uint8_t> ink; // w * h, one byte a pixel
+};
+
+// Renders c and crops the surface to the pixels that are set.
+static bool bake(TTF_Font *font, char c, Glyph &g) {
+    g.ch = c;
+    int minx, maxx, miny, maxy;
+    if (TTF_GlyphMetrics(font, static_cast<Uint8>(c), &minx, &maxx, &miny, &maxy, &g.advance) != 0) return false;
+    SDL_Surface *s = TTF_RenderGlyph_Solid(font, static_cast<Uint8>(c), SDL_Color{255, 255, 255, 255});
+    if (!s) return c == ' '; // SDL_ttf may give nothing for a blank glyph
+
+    int x0 = s->w, y0 = s->h, x1 = -1, y1 = -1;
+    const uint8_t *pixels = static_cast<const uint8_t *>(s->pixels);
+    for (int y = 0; y < s->h; ++y)
+        for (int x = 0; x < s->w; ++x)
+            if (pixels[y * s->pitch + x]) {
+                x0 = std::min(x0, x), x1 = std::max(x1, x);
+                y0 = std::min(y0, y), y1 = std::max(y1, y);
+            }
+    if (x1 >= 0) {
+        g.dx = x0;
+        g.dy = y0;
+        g.w = x1 - x0 + 1;
+        g.h = y1 - y0 + 1;
+        for (int y = y0; y <= y1; ++y)
+            for (int x = x0; x <= x1; ++x) g.ink.push_back(pixels[y * s->pitch + x] != 0);
+    }
+    SDL_FreeSurface(s);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 5 || argc > 6) {
+        std::fprintf(stderr, "usage: fontbake FONT.ttf SIZE NAME OUT.h [CHARS]\n");
+        return 2;
+    }
+    const char *fontPath = argv[1], *name = argv[3], *outPath = argv[4];
+    const int size = std::atoi(argv[2]);
+    std::string text = argc > 5 ? argv[5] : "Score: Game Over! Final Score: 0123456789";
+    std::set<char> chars(text.begin(), text.end());
+
+    TTF_Init();
+    TTF_Font *font = TTF_OpenFont(fontPath, size);
+    if (!font) {
+        std::fprintf(stderr, "fontbake: cannot open %s: %s\n", fontPath, TTF_GetError());
+        return 1;
+    }
+
+    std::vector<Glyph> glyphs;
+    int stripWidth = 0, stripHeight = 0;
+    for (char c : chars) {
+        Glyph g;
+        if (!bake(font, c, g)) {
+            std::fprintf(stderr, "fontbake: no glyph for '%c'\n", c);
+            return 1;
+        }
+        g.x = stripWidth;
+        stripWidth += g.w;
+        stripHeight = std::max(stripHeight, g.h);
+        glyphs.push_back(std::move(g));
+    }
+
+    const int pitch = (stripWidth + 7) / 8;
+    std::vector<uint8_t> bits(size_t(pitch) * stripHeight);
+    for (const Glyph &g : glyphs)
+        for (int y = 0; y < g.h; ++y)
+            for (int x = 0; x < g.w; ++x)
+                if (g.ink[y * g.w + x]) bits[y * pitch + (g.x + x) / 8] |= 1 << ((g.x + x) & 7);
+
+    FILE *out = std::fopen(outPath, "w");
+    if (!out) {
+        std::fprintf(stderr, "fontbake: cannot write %s\n", outPath);
+        return 1;
+    }
+    std::fprintf(out, "// Generated by `fontbake %s %d %s %s`; do not edit.\n", fontPath, size, name, outPath);
+    std::fprintf(out, "// %zu glyphs in a %dx%d strip, %zu bytes.\n", glyphs.size(), stripWidth, stripHeight, bits.size());
+    std::fprintf(out, "#pragma once\n\n#include \"bakedfont.h\"\n\nnamespace bakedfonts {\n\n");
+    std::fprintf(out, "const uint8_t %sBits[] = {", name);
+    for (size_t i = 0; i < bits.size(); ++i) std::fprintf(out, "%s0x%02x,", i % 16 ? " " : "\n    ", bits[i]);
+    std::fprintf(out, "\n};\n\nconst BakedGlyph %sGlyphs[] = {\n", name);
+    for (const Glyph &g : glyphs) {
+        std::string ch = g.ch == '\'' || g.ch == '\\' ? std::string("\\") + g.ch : std::string(1, g.ch);
+        std::fprintf(out, "    {'%s', %d, %d, %d, %d, %d, %d},\n", ch.c_str(), g.x, g.w, g.h, g.dx, g.dy, g.advance);
+    }
+    std::fprintf(out, "};\n\nconst BakedFontData %s = {%d, %d, %d, %d, %d, %sBits, %sGlyphs, %zu};\n\n", name, size,
+                 TTF_FontHeight(font), TTF_FontAscent(font), stripWidth, stripHeight, name, name, glyphs.size());
+    std::fprintf(out, "} // namespace bakedfonts\n");
+    std::fclose(out);
+
+    TTF_CloseFont(font);
+    TTF_Quit();
+    std::printf("fontbake: %zu glyphs, %zu bytes of bitmap\n", glyphs.size(), bits.size());
+    return 0;
+}
@@ -0,0 +1,70 @@
+// Checks a baked font against the TTF it was baked from: every label b.cpp
+// draws with font_arial28.h, for scores 0 to 9999, is rendered by
+// TextRenderer from the baked glyphs and by TTF_RenderText_Solid, and the two
+// surfaces must match in size and in every pixel that is set.
+//
+//   fontcheck arial.ttf
+//
+// Exits with 1, naming the first labels that differ, if any do. Run it after
+// regenerating font_arial28.h, or against a new SDL_ttf, whose hinting or
+// kerning may place pixels differently.
+#define SDL_MAIN_HANDLED
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <cstdio>
+#include "bakedfont.h"
+#include "font_arial28.h"
+
+// The number of pixels set in one surface and not the other, or -1 if the
+// sizes differ.
+static long differingPixels(SDL_Surface *a, SDL_Surface *b) {
+    if (a->w != b->w || a->h != b->h) return -1;
+    long differ = 0;
+    for (int y = 0; y < a->h; ++y) {
+        const uint8_t *ra = static_cast<const uint8_t *>(a->pixels) + size_t(y) * a->pitch;
+        const uint8_t *rb = static_cast<const uint8_t *>(b->pixels) + size_t(y) * b->pitch;
+        for (int x = 0; x < a->w; ++x) differ += (ra[x] != 0) != (rb[x] != 0);
+    }
+    return differ;
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: fontcheck FONT.ttf\n");
+        return 2;
+    }
+    TTF_Init();
+    TTF_Font *font = TTF_OpenFont(argv[1], bakedfonts::arial28.size);
+    if (!font) {
+        std::fprintf(stderr, "fontcheck: cannot open %s: %s\n", argv[1], TTF_GetError());
+        return 1;
+    }
+    TextRenderer baked(bakedfonts::arial28); // baked glyphs only
+
+    const SDL_Color white = {255, 255, 255, 255};
+    int checked = 0, failed = 0;
+    for (const char *format : {"Score: %d", "Game Over! Final Score: %d"}) {
+        for (int score = 0; score < 10000; ++score) {
+            char label[48];
+            std::snprintf(label, sizeof label, format, score);
+            SDL_Surface *mine = baked.renderSolid(label, white);
+            SDL_Surface *theirs = TTF_RenderText_Solid(font, label, white);
+            long differ = mine && theirs ? differingPixels(mine, theirs) : -1;
+            if (differ != 0 && ++failed <= 10) {
+                if (differ < 0)
+                    std::printf("\"%s\": %dx%d baked, %dx%d from the TTF\n", label, mine ? mine->w : 0, mine ? mine->h : 0,
+                                theirs ? theirs->w : 0, theirs ? theirs->h : 0);
+                else
+                    std::printf("\"%s\": %ld pixels differ\n", label, differ);
+            }
+            SDL_FreeSurface(mine);
+            SDL_FreeSurface(theirs);
+            checked++;
+        }
+    }
+
+    TTF_CloseFont(font);
+    TTF_Quit();
+    std::printf("fontcheck: %d of %d labels differ\n", failed, checked);
+    return failed ? 1 : 0;
+}
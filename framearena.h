@@ -0,0 +1,75 @@
+// Bump allocator for per-frame scratch data, usable as a std::pmr resource:
+//
+//   std::pmr::vector<SDL_Point> cells(&frameArena());
+//
+// Allocation is a pointer bump and deallocation is a no-op; everything is
+// released at once by reset() at the end of the frame. Requests that do not
+// fit spill to the heap until the next reset and are counted, so highWater()
+// tells how large the arena has to be for the biggest board we run.
+//
+// frameArena() belongs to the thread running the game loop. Worker threads
+// use threadArena(), which each thread resets when it finishes a job.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+class FrameArena : public std::pmr::memory_resource {
+public:
+    explicit FrameArena(size_t capacity) : buffer(new char[capacity]), cap(capacity) {}
+    ~FrameArena() { delete[] buffer; }
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void reset() {
+        if (spilled) overflow.release();
+        offset = 0;
+        spilled = 0;
+    }
+
+    size_t used() const { return offset + spilled; }
+    size_t capacity() const { return cap; }
+    size_t highWater() const { return peak; }         // most bytes in use in one frame
+    size_t overflowFrames() const { return overflows; } // frames that spilled to the heap
+
+private:
+    void* do_allocate(size_t bytes, size_t align) override {
+        uintptr_t base = reinterpret_cast<uintptr_t>(buffer);
+        size_t start = ((base + offset + align - 1) & ~(uintptr_t(align) - 1)) - base;
+        void* p;
+        if (start + bytes <= cap) {
+            p = buffer + start;
+            offset = start + bytes;
+        } else {
+            if (!spilled) overflows++;
+            p = overflow.allocate(bytes, align);
+            spilled += bytes;
+        }
+        if (used() > peak) peak = used();
+        return p;
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    char* buffer;
+    size_t cap;
+    size_t offset = 0;
+    size_t spilled = 0;
+    size_t peak = 0;
+    size_t overflows = 0;
+    std::pmr::monotonic_buffer_resource overflow{std::pmr::new_delete_resource()};
+};
+
+inline FrameArena& frameArena() {
+    static FrameArena arena(256 * 1024);
+    return arena;
+}
+
+inline FrameArena& threadArena() {
+    thread_local FrameArena arena(64 * 1024);
+    return arena;
+}
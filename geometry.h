@@ -0,0 +1,32 @@
+// Board geometry in tile indices: a tile is y * cols + x, and pixels only
+// come into it when a renderer asks for a tile's rectangle.
+//
+// FixedGeometry has the board size as compile-time constants, so dividing an
+// index back into x and y is a shift and a mask on power-of-two widths and a
+// multiply otherwise, and per-tile grids are std::arrays. a.cpp and b.cpp
+// both use it; boards sized when the program runs have rules::Board.
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+template <int Cols, int Rows>
+struct FixedGeometry {
+    static constexpr int cols = Cols, rows = Rows, cells = Cols * Rows;
+    using Index = std::conditional_t<(cells <= 65536), uint16_t, uint32_t>;
+    template <class T> using Grid = std::array<T, cells>;
+
+    template <class T> static constexpr Grid<T> grid() { return Grid<T>{}; }
+    static constexpr bool inside(int x, int y) { return unsigned(x) < unsigned(Cols) && unsigned(y) < unsigned(Rows); }
+    static constexpr Index index(int x, int y) { return Index(y * Cols + x); }
+    static constexpr int x(Index i) { return i % unsigned(Cols); }
+    static constexpr int y(Index i) { return i / unsigned(Cols); }
+    static constexpr SDL_Rect toRect(Index i, int tileSize) { return {x(i) * tileSize, y(i) * tileSize, tileSize, tileSize}; }
+};
+
+// A block of tiles in pixels.
+constexpr SDL_Rect tilesToPixels(const SDL_Rect &tiles, int tileSize) {
+    return {tiles.x * tileSize, tiles.y * tileSize, tiles.w * tileSize, tiles.h * tileSize};
+}
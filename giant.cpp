@@ -0,0 +1,91 @@
+// Giant-board snake. The board is far larger than the window; the camera
+// follows the head.
+//
+//   giant [TILES]   board of TILES x TILES tiles (default 8192)
+//
+// The minimap in the corner shows the whole board; M switches it between
+// levels of detail. Food and power-ups are scattered over the whole board,
+// one per 512 tiles.
+#include <SDL2/SDL.h>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include "giant.h"
+#include "minimap.h"
+#undef main
+using namespace std;
+
+const int WINDOW_WIDTH = 1080;
+const int WINDOW_HEIGHT = 720;
+const int TILE_SIZE = 20;
+const int MINIMAP_SIZE = 200;
+
+// Draws the minimap in the top-right corner with the camera outlined.
+void renderMinimap(SDL_Renderer* renderer, Minimap& minimap, int level, const Camera& camera, int tiles) {
+    SDL_Texture* texture = minimap.upload(renderer, level);
+    SDL_Rect dst = {WINDOW_WIDTH - MINIMAP_SIZE - 10, 10, MINIMAP_SIZE, MINIMAP_SIZE};
+    SDL_RenderCopy(renderer, texture, nullptr, &dst);
+
+    SDL_Rect view = {dst.x + camera.x * MINIMAP_SIZE / tiles, dst.y + camera.y * MINIMAP_SIZE / tiles,
+                     camera.w * MINIMAP_SIZE / tiles + 1, camera.h * MINIMAP_SIZE / tiles + 1};
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderDrawRect(renderer, &view);
+}
+
+int main(int argc, char* argv[]) {
+    int tiles = argc > 1 ? atoi(argv[1]) : 8192;
+    if (tiles < 64) tiles = 64;
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        cerr << "Failed to initialize SDL: " << SDL_GetError() << endl;
+        return 1;
+    }
+    SDL_Window* window = SDL_CreateWindow("Snake Game", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_SHOWN);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+
+    GiantGame game(tiles, tiles, static_cast<unsigned>(time(0)));
+    game.scatterItems(size_t(tiles) * tiles / 512);
+    Camera camera(WINDOW_WIDTH / TILE_SIZE, WINDOW_HEIGHT / TILE_SIZE);
+    Minimap minimap(game.board, 256, 4);
+    game.board.observe(&minimap);
+    int minimapLevel = 0;
+    int dx = 1, dy = 0;
+    bool running = true;
+    SDL_Event event;
+
+    while (running) {
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_QUIT) {
+                running = false;
+            } else if (event.type == SDL_KEYDOWN) {
+                switch (event.key.keysym.sym) {
+                    case SDLK_UP:    if (dy != 1)  { dx = 0; dy = -1; } break;
+                    case SDLK_DOWN:  if (dy != -1) { dx = 0; dy = 1; } break;
+                    case SDLK_LEFT:  if (dx != 1)  { dx = -1; dy = 0; } break;
+                    case SDLK_RIGHT: if (dx != -1) { dx = 1; dy = 0; } break;
+                    case SDLK_m: minimapLevel = (minimapLevel + 1) % minimap.levelCount(); break;
+                }
+            }
+        }
+
+        if (!game.step(dx, dy)) {
+            cout << "Game Over! Your Score: " << game.score << endl;
+            running = false;
+        }
+
+        camera.follow(game.body.head(), tiles, tiles);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        game.render(renderer, camera, TILE_SIZE);
+        renderMinimap(renderer, minimap, minimapLevel, camera, tiles);
+        SDL_RenderPresent(renderer);
+        frameArena().reset();
+        SDL_Delay(game.effect(ITEM_SPEED) ? 50 : 100);
+    }
+
+    game.board.observe(nullptr);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return 0;
+}
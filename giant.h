@@ -0,0 +1,303 @@
+// Giant-board snake: boards far larger than the window, stored in chunks,
+// with a camera that follows the head and draws only what it can see.
+//
+// Any number of food items and power-ups can be out at once (itempool.h).
+// Power-ups last EFFECT_TICKS steps, timed on a wheel (timerwheel.h):
+//   speed   giant.cpp steps twice as often
+//   shrink  the tail loses SHRINK_CELLS at once
+//   ghost   the head passes over the body
+//   magnet  food within MAGNET_RANGE tiles of the head is eaten
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstdlib>
+#include <memory_resource>
+#include <random>
+#include <vector>
+#include "chunkboard.h"
+#include "framearena.h"
+#include "itempool.h"
+#include "runbody.h"
+#include "timerwheel.h"
+
+// The part of the board on screen, in tiles.
+struct Camera {
+    int x = 0, y = 0;
+    int w, h;
+
+    Camera(int widthTiles, int heightTiles) : w(widthTiles), h(heightTiles) {}
+
+    // Centres on the head, clamped so the view never leaves the board.
+    void follow(SDL_Point head, int boardW, int boardH) {
+        x = head.x - w / 2;
+        y = head.y - h / 2;
+        if (x > boardW - w) x = boardW - w;
+        if (y > boardH - h) y = boardH - h;
+        if (x < 0) x = 0;
+        if (y < 0) y = 0;
+    }
+};
+
+class GiantGame {
+public:
+    // withWalls adds a border and scattered wall segments.
+    GiantGame(int widthTiles, int heightTiles, unsigned seed, bool withWalls = true)
+        : board(widthTiles, heightTiles), items(widthTiles), rng(seed), crossings(widthTiles) {
+        if (withWalls) buildWalls();
+        SDL_Point start = {widthTiles / 2, heightTiles / 2};
+        board.set(start.x, start.y, SNAKE); // walls keep clear of the centre
+        body.reset(start.x, start.y);
+        spawnFood();
+    }
+
+    static const int EFFECT_TICKS = 80;
+    static const int SHRINK_CELLS = 16;
+    static const int MAGNET_RANGE = 3;
+
+    // Advances one tick in direction (dx, dy). Returns false when the snake
+    // hits a wall, itself or the edge of the board.
+    bool step(int dx, int dy) {
+        // Effects are timed in steps taken while any is running; between
+        // them the wheel stands still.
+        if (timers.size()) timers.advance([&](ItemKind kind) { active[kind] = false; });
+        SDL_Point head = body.head();
+        int x = head.x + dx, y = head.y + dy;
+        if (!board.inside(x, y)) return false;
+
+        // The tail moves out of the way first, so following it is allowed.
+        if (growth > 0) growth--;
+        else retractTail();
+
+        Tile t = board.get(x, y);
+        if (t == WALL || (t == SNAKE && !active[ITEM_GHOST])) return false;
+
+        body.advanceHead(dx, dy);
+        if (t == SNAKE) cross(x, y);
+        else board.set(x, y, SNAKE);
+        if (t == FOOD) pickUp(x, y);
+        if (active[ITEM_MAGNET]) attract(x, y);
+        return true;
+    }
+
+    // Puts up to count items on empty tiles across the board, a little over
+    // half of them food and the rest power-ups. Returns how many fitted.
+    size_t scatterItems(size_t count) {
+        items.reserve(items.size() + count);
+        std::uniform_int_distribution<int> px(0, board.width() - 1), py(0, board.height() - 1), roll(0, 99);
+        size_t placed = 0;
+        for (size_t attempt = 0; placed < count && attempt < count * 4; ++attempt) {
+            int x = px(rng), y = py(rng);
+            if (board.get(x, y) != EMPTY) continue;
+            int r = roll(rng);
+            placeItem(x, y, r < 60 ? ITEM_FOOD : ItemKind(ITEM_SPEED + (r - 60) / 10));
+            placed++;
+        }
+        return placed;
+    }
+
+    void placeItem(int x, int y, ItemKind kind) {
+        if (items.add(x, y, kind)) board.set(x, y, FOOD);
+    }
+
+    void removeItem(int x, int y) {
+        ItemKind kind;
+        if (items.take(x, y, kind)) board.set(x, y, EMPTY);
+    }
+
+    bool effect(ItemKind kind) const { return active[kind]; }
+
+    // A lasting power-up takes effect for EFFECT_TICKS steps, starting over
+    // if it already had.
+    void startEffect(ItemKind kind) {
+        timers.cancel(effectTimers[kind]);
+        effectTimers[kind] = timers.after(EFFECT_TICKS, kind);
+        active[kind] = true;
+    }
+
+    // Draws the tiles inside the camera. Only chunks overlapping the view are
+    // visited and empty chunks are skipped, and runs of equal tiles in a row
+    // are merged, so the cost depends on the window and not the board.
+    // Returns the number of rectangles submitted.
+    int render(SDL_Renderer* renderer, const Camera& cam, int tileSize) const {
+        std::pmr::vector<SDL_Rect> batches[4] = {std::pmr::vector<SDL_Rect>(&frameArena()),
+                                                 std::pmr::vector<SDL_Rect>(&frameArena()),
+                                                 std::pmr::vector<SDL_Rect>(&frameArena()),
+                                                 std::pmr::vector<SDL_Rect>(&frameArena())};
+        struct PowerUp {
+            SDL_Rect rect;
+            ItemKind kind;
+        };
+        std::pmr::vector<PowerUp> powerUps(&frameArena()); // few on screen; drawn one by one
+
+        const int x1 = cam.x + cam.w, y1 = cam.y + cam.h;
+        const int cx0 = cam.x >> ChunkedBoard::CHUNK_SHIFT, cx1 = (x1 - 1) >> ChunkedBoard::CHUNK_SHIFT;
+        const int cy0 = cam.y >> ChunkedBoard::CHUNK_SHIFT, cy1 = (y1 - 1) >> ChunkedBoard::CHUNK_SHIFT;
+
+        for (int cy = cy0; cy <= cy1 && cy < board.chunkRows(); ++cy) {
+            for (int cx = cx0; cx <= cx1 && cx < board.chunkColumns(); ++cx) {
+                const ChunkedBoard::Chunk* chunk = board.chunk(cx, cy);
+                if (!chunk || chunk->nonEmpty == 0) continue;
+
+                int tx0 = cx << ChunkedBoard::CHUNK_SHIFT, ty0 = cy << ChunkedBoard::CHUNK_SHIFT;
+                int sx0 = tx0 > cam.x ? tx0 : cam.x, sy0 = ty0 > cam.y ? ty0 : cam.y;
+                int sx1 = tx0 + ChunkedBoard::CHUNK < x1 ? tx0 + ChunkedBoard::CHUNK : x1;
+                int sy1 = ty0 + ChunkedBoard::CHUNK < y1 ? ty0 + ChunkedBoard::CHUNK : y1;
+
+                for (int y = sy0; y < sy1; ++y) {
+                    const uint8_t* row = chunk->tiles + (y - ty0) * ChunkedBoard::CHUNK;
+                    for (int x = sx0; x < sx1;) {
+                        uint8_t t = row[x - tx0];
+                        int run = x + 1;
+                        while (run < sx1 && row[run - tx0] == t) ++run;
+                        if (t == FOOD) {
+                            for (int i = x; i < run; ++i) {
+                                uint32_t item = items.find(i, y);
+                                ItemKind kind = item == ItemPool::NONE ? ITEM_FOOD : items.kind(item);
+                                SDL_Rect r = {(i - cam.x) * tileSize, (y - cam.y) * tileSize, tileSize, tileSize};
+                                if (kind == ITEM_FOOD) batches[FOOD].push_back(r);
+                                else powerUps.push_back({r, kind});
+                            }
+                        } else if (t != EMPTY) {
+                            batches[t].push_back({(x - cam.x) * tileSize, (y - cam.y) * tileSize,
+                                                  (run - x) * tileSize, tileSize});
+                        }
+                        x = run;
+                    }
+                }
+            }
+        }
+
+        static const SDL_Color colors[4] = {{0, 0, 0, 0}, {0, 80, 70, 255}, {0, 255, 0, 255}, {255, 0, 0, 255}};
+        int rects = 0;
+        for (int t = WALL; t <= FOOD; ++t) {
+            if (batches[t].empty()) continue;
+            SDL_SetRenderDrawColor(renderer, colors[t].r, colors[t].g, colors[t].b, colors[t].a);
+            SDL_RenderFillRects(renderer, batches[t].data(), static_cast<int>(batches[t].size()));
+            rects += static_cast<int>(batches[t].size());
+        }
+        static const SDL_Color powerUpColors[ITEM_KINDS] = {
+            {255, 0, 0, 255}, {255, 220, 0, 255}, {160, 80, 255, 255}, {220, 220, 220, 255}, {0, 160, 255, 255}};
+        for (const PowerUp &p : powerUps) {
+            const SDL_Color &c = powerUpColors[p.kind];
+            SDL_SetRenderDrawColor(renderer, c.r, c.g, c.b, c.a);
+            SDL_RenderFillRect(renderer, &p.rect);
+        }
+        return rects + static_cast<int>(powerUps.size());
+    }
+
+    ChunkedBoard board;
+    ItemPool items; // what is on each FOOD tile
+    RunBody body;
+    SDL_Point food = {0, 0}; // the food last put near the head
+    int score = 0;
+    int growth = 0;
+
+private:
+    // The head goes over the body: the tile stays body until both leave.
+    void cross(int x, int y) {
+        if (uint32_t *passes = crossings.find(x, y)) ++*passes;
+        else crossings.insert(x, y, 1);
+    }
+
+    // Leaves a crossed tile marked as body while the other pass is on it.
+    void retractTail() {
+        SDL_Point tail = body.tail();
+        body.retractTail();
+        if (crossings.size()) {
+            if (uint32_t *passes = crossings.find(tail.x, tail.y)) {
+                if (--*passes == 0) crossings.erase(tail.x, tail.y);
+                return;
+            }
+        }
+        board.set(tail.x, tail.y, EMPTY);
+    }
+
+    // The item on (x, y) is eaten; the board is the caller's to update.
+    void pickUp(int x, int y) {
+        ItemKind kind;
+        if (!items.take(x, y, kind)) return;
+        switch (kind) {
+        case ITEM_FOOD:
+            score++;
+            growth += 4;
+            spawnFood();
+            return;
+        case ITEM_SHRINK:
+            growth = 0;
+            for (int i = 0; i < SHRINK_CELLS && body.size() > 2; ++i) retractTail();
+            return;
+        default:
+            startEffect(kind);
+            return;
+        }
+    }
+
+    // The food in range is found before any is eaten, so food that eating
+    // it puts in range waits for the next step.
+    void attract(int hx, int hy) {
+        const int SIDE = 2 * MAGNET_RANGE + 1;
+        SDL_Point inRange[SIDE * SIDE];
+        int n = 0;
+        for (int y = hy - MAGNET_RANGE; y <= hy + MAGNET_RANGE; ++y)
+            for (int x = hx - MAGNET_RANGE; x <= hx + MAGNET_RANGE; ++x) {
+                if (!board.inside(x, y) || board.get(x, y) != FOOD) continue;
+                uint32_t item = items.find(x, y);
+                if (item != ItemPool::NONE && items.kind(item) == ITEM_FOOD) inRange[n++] = {x, y};
+            }
+        for (int i = 0; i < n; ++i) {
+            board.set(inRange[i].x, inRange[i].y, EMPTY);
+            pickUp(inRange[i].x, inRange[i].y);
+        }
+    }
+
+    // A border plus one short wall per 128x128 tiles, kept away from the
+    // centre where the snake starts.
+    void buildWalls() {
+        int w = board.width(), h = board.height();
+        for (int x = 0; x < w; ++x) {
+            board.set(x, 0, WALL);
+            board.set(x, h - 1, WALL);
+        }
+        for (int y = 0; y < h; ++y) {
+            board.set(0, y, WALL);
+            board.set(w - 1, y, WALL);
+        }
+
+        std::uniform_int_distribution<int> len(4, 32);
+        int segments = (w / 128 + 1) * (h / 128 + 1);
+        for (int i = 0; i < segments; ++i) {
+            int x = std::uniform_int_distribution<int>(1, w - 2)(rng);
+            int y = std::uniform_int_distribution<int>(1, h - 2)(rng);
+            bool horizontal = rng() & 1;
+            int n = len(rng);
+            for (int k = 0; k < n; ++k) {
+                int wx = horizontal ? x + k : x, wy = horizontal ? y : y + k;
+                if (!board.inside(wx, wy)) break;
+                if (std::abs(wx - w / 2) < 8 && std::abs(wy - h / 2) < 8) continue;
+                board.set(wx, wy, WALL);
+            }
+        }
+    }
+
+    // Food appears within FOOD_RANGE tiles of the head so it can be found on
+    // a board thousands of screens wide.
+    void spawnFood() {
+        const int FOOD_RANGE = 64;
+        SDL_Point head = body.head();
+        std::uniform_int_distribution<int> offset(-FOOD_RANGE, FOOD_RANGE);
+        for (int attempt = 0; attempt < 1000; ++attempt) {
+            int x = head.x + offset(rng), y = head.y + offset(rng);
+            if (board.inside(x, y) && board.get(x, y) == EMPTY) {
+                food = {x, y};
+                placeItem(x, y, ITEM_FOOD);
+                return;
+            }
+        }
+    }
+
+    std::mt19937 rng;
+    TimerWheel<ItemKind> timers;
+    TimerHandle effectTimers[ITEM_KINDS];
+    bool active[ITEM_KINDS] = {};
+    TileMap crossings; // per tile the body covers more than once, the extra passes
+};
@@ -0,0 +1,534 @@
+// Encoders for frames leaving the game: PNG and BMP images and Y4M video
+// frames from RGBA32 pixels (bytes R, G, B, A, as in softraster.h), and animated GIF or
+// APNG from palette-indexed frames.
+//
+// No zlib is needed. The PNG writer emits a single fixed-Huffman deflate
+// block whose only matches repeat the previous pixel or the row above, which
+// is enough to shrink the flat-coloured frames of a tile game to a few
+// percent of their raw size.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace imageio {
+
+inline uint32_t crc32(const uint8_t *p, size_t n, uint32_t crc = 0) {
+    static uint32_t table[256];
+    static bool ready = [] {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        return true;
+    }();
+    (void)ready;
+    crc = ~crc;
+    for (size_t i = 0; i < n; ++i) crc = table[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+inline void putBE32(std::vector<uint8_t> &out, uint32_t v) {
+    out.push_back(v >> 24);
+    out.push_back(v >> 16);
+    out.push_back(v >> 8);
+    out.push_back(v);
+}
+
+// Deflate bits go out least significant bit first.
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t> &out) : out(out) {}
+
+    void bits(uint32_t value, int count) {
+        acc |= uint64_t(value) << filled;
+        filled += count;
+        while (filled >= 8) {
+            out.push_back(static_cast<uint8_t>(acc));
+            acc >>= 8;
+            filled -= 8;
+        }
+    }
+
+    // Huffman codes are defined most significant bit first.
+    void code(uint32_t value, int count) {
+        uint32_t reversed = 0;
+        for (int i = 0; i < count; ++i) reversed |= ((value >> i) & 1) << (count - 1 - i);
+        bits(reversed, count);
+    }
+
+    void flush() {
+        if (filled > 0) out.push_back(static_cast<uint8_t>(acc));
+        acc = 0;
+        filled = 0;
+    }
+
+private:
+    std::vector<uint8_t> &out;
+    uint64_t acc = 0;
+    int filled = 0;
+};
+
+inline void literal(BitWriter &w, unsigned symbol) {
+    if (symbol < 144) w.code(0x30 + symbol, 8);
+    else if (symbol < 256) w.code(0x190 + symbol - 144, 9);
+    else if (symbol < 280) w.code(symbol - 256, 7);
+    else w.code(0xc0 + symbol - 280, 8);
+}
+
+// A back-reference of 3..258 bytes at distance 1..32768.
+inline void match(BitWriter &w, unsigned length, unsigned distance) {
+    static const uint16_t lengthBase[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                            31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const uint8_t lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                            2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const uint16_t distBase[30] = {1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+                                          193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static const uint8_t distExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    int l = 28;
+    while (lengthBase[l] > length) --l;
+    literal(w, 257 + l);
+    w.bits(length - lengthBase[l], lengthExtra[l]);
+    int d = 29;
+    while (distBase[d] > distance) --d;
+    w.code(d, 5);
+    w.bits(distance - distBase[d], distExtra[d]);
+}
+
+// zlib stream of data, matching only at distances `near` and `far`.
+inline void deflate(std::vector<uint8_t> &out, const std::vector<uint8_t> &data, size_t near, size_t far) {
+    out.push_back(0x78); // deflate, 32K window
+    out.push_back(0x01);
+    BitWriter w(out);
+    w.bits(1, 1); // final block
+    w.bits(1, 2); // fixed Huffman codes
+
+    // Length of the match at i, comparing eight bytes at a time.
+    const uint8_t *base = data.data();
+    auto runAt = [&](size_t i, size_t distance) {
+        size_t n = 0;
+        if (distance == 0 || distance > 32768 || i < distance) return n;
+        size_t limit = std::min<size_t>(258, data.size() - i);
+        const uint8_t *a = base + i, *b = a - distance;
+        for (uint64_t x, y; n + 8 <= limit; n += 8) {
+            std::memcpy(&x, a + n, 8);
+            std::memcpy(&y, b + n, 8);
+            if (x != y) break;
+        }
+        while (n < limit && a[n] == b[n]) ++n;
+        return n;
+    };
+    for (size_t i = 0; i < data.size();) {
+        size_t a = runAt(i, near), b = a == 258 ? 0 : runAt(i, far);
+        size_t length = a >= b ? a : b;
+        if (length >= 3) {
+            match(w, static_cast<unsigned>(length), static_cast<unsigned>(a >= b ? near : far));
+            i += length;
+        } else {
+            literal(w, data[i++]);
+        }
+    }
+    literal(w, 256);
+    w.flush();
+
+    // Adler-32, reducing only every 5552 bytes as zlib does.
+    uint32_t s1 = 1, s2 = 0;
+    for (size_t i = 0; i < data.size();) {
+        size_t end = std::min(data.size(), i + 5552);
+        for (; i < end; ++i) {
+            s1 += data[i];
+            s2 += s1;
+        }
+        s1 %= 65521;
+        s2 %= 65521;
+    }
+    putBE32(out, s2 << 16 | s1);
+}
+
+inline void chunk(std::vector<uint8_t> &out, const char *type, const std::vector<uint8_t> &body) {
+    putBE32(out, static_cast<uint32_t>(body.size()));
+    size_t start = out.size();
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), body.begin(), body.end());
+    putBE32(out, crc32(out.data() + start, out.size() - start));
+}
+
+} // namespace imageio
+
+// An RGB PNG of the image into out (replacing its contents).
+inline void encodePng(std::vector<uint8_t> &out, const uint8_t *rgba, int width, int height, int pitch) {
+    using namespace imageio;
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    out.assign(signature, signature + 8);
+
+    std::vector<uint8_t> header;
+    putBE32(header, width);
+    putBE32(header, height);
+    header.insert(header.end(), {8, 2, 0, 0, 0}); // 8-bit RGB, no interlace
+    chunk(out, "IHDR", header);
+
+    // Each row is filter type 0 followed by its RGB bytes.
+    size_t rowBytes = size_t(width) * 3 + 1;
+    std::vector<uint8_t> raw(rowBytes * height);
+    for (int y = 0; y < height; ++y) {
+        uint8_t *dst = raw.data() + y * rowBytes;
+        const uint8_t *src = rgba + size_t(y) * pitch;
+        *dst++ = 0;
+        for (int x = 0; x < width; ++x, src += 4) {
+            *dst++ = src[0];
+            *dst++ = src[1];
+            *dst++ = src[2];
+        }
+    }
+    std::vector<uint8_t> compressed;
+    deflate(compressed, raw, 3, rowBytes);
+    chunk(out, "IDAT", compressed);
+    chunk(out, "IEND", {});
+}
+
+// A 24-bit BMP of the image into out (replacing its contents). No
+// compression, so it is the cheapest to encode and the largest on disk.
+inline void encodeBmp(std::vector<uint8_t> &out, const uint8_t *rgba, int width, int height, int pitch) {
+    const size_t rowBytes = (size_t(width) * 3 + 3) & ~size_t(3);
+    const uint32_t imageBytes = static_cast<uint32_t>(rowBytes * height);
+    out.assign({'B', 'M'});
+    out.resize(54 + imageBytes);
+    auto le32 = [&](size_t at, uint32_t v) {
+        for (int i = 0; i < 4; ++i) out[at + i] = static_cast<uint8_t>(v >> (8 * i));
+    };
+    le32(2, 54 + imageBytes); // file size
+    le32(10, 54);             // pixel data offset
+    le32(14, 40);             // BITMAPINFOHEADER
+    le32(18, width);
+    le32(22, height);         // positive: rows bottom-up
+    le32(26, 1 | 24 << 16);   // one plane, 24 bits per pixel
+    le32(34, imageBytes);
+    le32(38, 2835);           // 72 dpi
+    le32(42, 2835);
+
+    for (int y = 0; y < height; ++y) {
+        const uint8_t *src = rgba + size_t(height - 1 - y) * pitch;
+        uint8_t *dst = out.data() + 54 + y * rowBytes;
+        for (int x = 0; x < width; ++x, src += 4) {
+            *dst++ = src[2];
+            *dst++ = src[1];
+            *dst++ = src[0];
+        }
+    }
+}
+
+inline bool writeFile(const char *path, const std::vector<uint8_t> &bytes) {
+    FILE *f = std::fopen(path, "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(bytes.data(), 1, bytes.size(), f) == bytes.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+// YUV4MPEG2 stream header for 4:2:0 frames; width and height must be even.
+inline void y4mHeader(std::vector<uint8_t> &out, int width, int height, int fps) {
+    char text[96];
+    int n = std::snprintf(text, sizeof text, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, fps);
+    out.assign(text, text + n);
+}
+
+// One Y4M frame into out (replacing its contents): BT.601 studio range,
+// chroma averaged over each 2x2 block.
+inline void encodeY4mFrame(std::vector<uint8_t> &out, const uint8_t *rgba, int width, int height, int pitch) {
+    static const char tag[] = "FRAME\n";
+    size_t lumaSize = size_t(width) * height, chromaSize = lumaSize / 4;
+    out.resize(6 + lumaSize + 2 * chromaSize);
+    std::copy(tag, tag + 6, out.begin());
+    uint8_t *yPlane = out.data() + 6, *uPlane = yPlane + lumaSize, *vPlane = uPlane + chromaSize;
+
+    for (int y = 0; y < height; ++y) {
+        const uint8_t *p = rgba + size_t(y) * pitch;
+        for (int x = 0; x < width; ++x, p += 4)
+            yPlane[size_t(y) * width + x] = static_cast<uint8_t>(((66 * p[0] + 129 * p[1] + 25 * p[2] + 128) >> 8) + 16);
+    }
+    for (int y = 0; y < height / 2; ++y) {
+        const uint8_t *top = rgba + size_t(2 * y) * pitch, *bottom = top + pitch;
+        for (int x = 0; x < width / 2; ++x) {
+            int r = top[8 * x] + top[8 * x + 4] + bottom[8 * x] + bottom[8 * x + 4];
+            int g = top[8 * x + 1] + top[8 * x + 5] + bottom[8 * x + 1] + bottom[8 * x + 5];
+            int b = top[8 * x + 2] + top[8 * x + 6] + bottom[8 * x + 2] + bottom[8 * x + 6];
+            // Sums of four pixels: shift by 10 instead of 8.
+            uPlane[size_t(y) * (width / 2) + x] = static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 512) >> 10) + 128);
+            vPlane[size_t(y) * (width / 2) + x] = static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 512) >> 10) + 128);
+        }
+    }
+}
+
+namespace imageio {
+
+// GIF's variable-width LZW over a w x h block of 8-bit pixels, as the
+// minimum-code-size byte followed by data sub-blocks and a terminator.
+inline void gifLzw(std::vector<uint8_t> &out, const uint8_t *pixels, int pitch, int w, int h, int minCodeSize) {
+    const unsigned clear = 1u << minCodeSize, eoi = clear + 1;
+    out.push_back(static_cast<uint8_t>(minCodeSize));
+
+    uint8_t block[255];
+    int blockSize = 0;
+    uint32_t acc = 0;
+    int filled = 0, width = minCodeSize + 1;
+    auto emit = [&](unsigned code) {
+        acc |= code << filled;
+        filled += width;
+        while (filled >= 8) {
+            block[blockSize++] = static_cast<uint8_t>(acc);
+            acc >>= 8;
+            filled -= 8;
+            if (blockSize == 255) {
+                out.push_back(255);
+                out.insert(out.end(), block, block + 255);
+                blockSize = 0;
+            }
+        }
+    };
+
+    // Dictionary of (prefix code, next pixel) -> code, open addressing.
+    const int HASH = 1 << 13;
+    std::vector<int32_t> keys(HASH, -1);
+    std::vector<uint16_t> codes(HASH);
+    unsigned next = eoi + 1;
+    emit(clear);
+
+    int prefix = -1;
+    for (int y = 0; y < h; ++y) {
+        const uint8_t *row = pixels + size_t(y) * pitch;
+        for (int x = 0; x < w; ++x) {
+            unsigned k = row[x];
+            if (prefix < 0) {
+                prefix = static_cast<int>(k);
+                continue;
+            }
+            int32_t key = prefix << 8 | static_cast<int32_t>(k);
+            unsigned slot = (static_cast<uint32_t>(key) * 2654435761u) >> (32 - 13);
+            while (keys[slot] != -1 && keys[slot] != key) slot = (slot + 1) & (HASH - 1);
+            if (keys[slot] == key) {
+                prefix = codes[slot];
+                continue;
+            }
+
+            emit(static_cast<unsigned>(prefix));
+            keys[slot] = key;
+            codes[slot] = static_cast<uint16_t>(next++);
+            if (next - 1 >= (1u << width)) width++; // the last code no longer fits
+            if (next == 4096) {
+                emit(clear);
+                std::fill(keys.begin(), keys.end(), -1);
+                next = eoi + 1;
+                width = minCodeSize + 1;
+            }
+            prefix = static_cast<int>(k);
+        }
+    }
+    if (prefix >= 0) emit(static_cast<unsigned>(prefix));
+    emit(eoi);
+    if (filled > 0) block[blockSize++] = static_cast<uint8_t>(acc);
+    if (blockSize > 0) {
+        out.push_back(static_cast<uint8_t>(blockSize));
+        out.insert(out.end(), block, block + blockSize);
+    }
+    out.push_back(0);
+}
+
+inline void putLE16(std::vector<uint8_t> &out, unsigned v) {
+    out.push_back(static_cast<uint8_t>(v));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+inline void putBE16(std::vector<uint8_t> &out, unsigned v) {
+    out.push_back(static_cast<uint8_t>(v >> 8));
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+// Recomputes the CRC of the PNG chunk starting at offset after its body was
+// patched in place.
+inline void fixChunkCrc(std::vector<uint8_t> &out, size_t offset) {
+    uint32_t length = uint32_t(out[offset]) << 24 | out[offset + 1] << 16 | out[offset + 2] << 8 | out[offset + 3];
+    uint32_t crc = crc32(out.data() + offset + 4, length + 4);
+    uint8_t *p = out.data() + offset + 8 + length;
+    p[0] = crc >> 24;
+    p[1] = crc >> 16;
+    p[2] = crc >> 8;
+    p[3] = crc;
+}
+
+} // namespace imageio
+
+// Animated GIF or APNG built from palette-indexed frames of one size. Each
+// frame stores only the rectangle that differs from the frame before, drawn
+// over it (GIF disposal "none", APNG dispose/blend "none"/"source"), and an
+// unchanged frame just lengthens the one before. The palette is fixed up
+// front, so every index a frame uses must already be in it.
+class AnimationEncoder {
+public:
+    enum Format { GIF, APNG };
+
+    AnimationEncoder(Format format, int width, int height, const std::vector<uint32_t> &palette, int frameMs)
+        : format(format), w(width), h(height), frameMs(frameMs), previous(size_t(width) * height) {
+        using namespace imageio;
+        colorBits = 1;
+        while ((1u << colorBits) < palette.size() && colorBits < 8) colorBits++;
+
+        if (format == GIF) {
+            const char magic[] = "GIF89a";
+            out.assign(magic, magic + 6);
+            putLE16(out, width);
+            putLE16(out, height);
+            out.push_back(static_cast<uint8_t>(0xf0 | (colorBits - 1))); // global table, 8-bit colour
+            out.push_back(0); // background index
+            out.push_back(0); // square pixels
+            for (unsigned i = 0; i < (1u << colorBits); ++i) {
+                uint32_t c = i < palette.size() ? palette[i] : 0;
+                const uint8_t *rgba = reinterpret_cast<const uint8_t *>(&c);
+                out.insert(out.end(), rgba, rgba + 3);
+            }
+            const uint8_t loop[] = {0x21, 0xff, 11, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.', '0', 3, 1, 0, 0, 0};
+            out.insert(out.end(), loop, loop + sizeof loop);
+        } else {
+            static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+            out.assign(signature, signature + 8);
+            std::vector<uint8_t> body;
+            putBE32(body, width);
+            putBE32(body, height);
+            body.insert(body.end(), {8, 3, 0, 0, 0}); // 8-bit palette indices
+            chunk(out, "IHDR", body);
+            actlOffset = out.size();
+            body.assign(8, 0); // frame count, patched by finish(); loop forever
+            chunk(out, "acTL", body);
+            body.clear();
+            for (uint32_t c : palette) {
+                const uint8_t *rgba = reinterpret_cast<const uint8_t *>(&c);
+                body.insert(body.end(), rgba, rgba + 3);
+            }
+            chunk(out, "PLTE", body);
+        }
+    }
+
+    void addFrame(const uint8_t *indices, int pitch) {
+        int x0 = w, y0 = h, x1 = -1, y1 = -1;
+        for (int y = 0; y < h; ++y) {
+            const uint8_t *row = indices + size_t(y) * pitch, *old = previous.data() + size_t(y) * w;
+            if (frames > 0 && std::memcmp(row, old, w) == 0) continue;
+            int first = 0, last = w - 1;
+            if (frames > 0) {
+                while (row[first] == old[first]) ++first;
+                while (row[last] == old[last]) --last;
+            }
+            x0 = std::min(x0, first);
+            x1 = std::max(x1, last);
+            y0 = std::min(y0, y);
+            y1 = y;
+            std::memcpy(previous.data() + size_t(y) * w, row, w);
+        }
+
+        if (x1 < 0) { // nothing changed
+            pending.delayMs += frameMs;
+            return;
+        }
+        flush();
+        pending.x = x0;
+        pending.y = y0;
+        pending.w = x1 - x0 + 1;
+        pending.h = y1 - y0 + 1;
+        pending.delayMs = frameMs;
+        pending.data.clear();
+        const uint8_t *origin = previous.data() + size_t(y0) * w + x0;
+        if (format == GIF) {
+            imageio::gifLzw(pending.data, origin, w, pending.w, pending.h, colorBits < 2 ? 2 : colorBits);
+        } else {
+            std::vector<uint8_t> raw;
+            raw.reserve(size_t(pending.w + 1) * pending.h);
+            for (int y = 0; y < pending.h; ++y) {
+                raw.push_back(0);
+                raw.insert(raw.end(), origin + size_t(y) * w, origin + size_t(y) * w + pending.w);
+            }
+            imageio::deflate(pending.data, raw, 1, pending.w + 1);
+        }
+        frames++;
+    }
+
+    // The finished file. The encoder cannot be used afterwards.
+    std::vector<uint8_t> finish() {
+        using namespace imageio;
+        flush();
+        if (format == GIF) {
+            out.push_back(0x3b);
+        } else {
+            out[actlOffset + 8] = static_cast<uint8_t>(frames >> 24);
+            out[actlOffset + 9] = static_cast<uint8_t>(frames >> 16);
+            out[actlOffset + 10] = static_cast<uint8_t>(frames >> 8);
+            out[actlOffset + 11] = static_cast<uint8_t>(frames);
+            fixChunkCrc(out, actlOffset);
+            chunk(out, "IEND", {});
+        }
+        return std::move(out);
+    }
+
+    size_t frameCount() const { return frames; }
+
+private:
+    struct Frame {
+        int x = 0, y = 0, w = 0, h = 0;
+        int delayMs = 0;
+        std::vector<uint8_t> data; // LZW or zlib stream
+    };
+
+    // Writes the pending frame, now that its delay is known.
+    void flush() {
+        using namespace imageio;
+        if (pending.data.empty()) return;
+        if (format == GIF) {
+            const uint8_t control[] = {0x21, 0xf9, 4, 1 << 2}; // disposal: leave in place
+            out.insert(out.end(), control, control + 4);
+            putLE16(out, (pending.delayMs + 5) / 10);
+            out.push_back(0);
+            out.push_back(0);
+            out.push_back(0x2c);
+            putLE16(out, pending.x);
+            putLE16(out, pending.y);
+            putLE16(out, pending.w);
+            putLE16(out, pending.h);
+            out.push_back(0);
+            out.insert(out.end(), pending.data.begin(), pending.data.end());
+        } else {
+            std::vector<uint8_t> body;
+            putBE32(body, sequence++);
+            putBE32(body, pending.w);
+            putBE32(body, pending.h);
+            putBE32(body, pending.x);
+            putBE32(body, pending.y);
+            putBE16(body, pending.delayMs);
+            putBE16(body, 1000);
+            body.push_back(0); // APNG_DISPOSE_OP_NONE
+            body.push_back(0); // APNG_BLEND_OP_SOURCE
+            chunk(out, "fcTL", body);
+            if (sequence == 1) {
+                chunk(out, "IDAT", pending.data);
+            } else {
+                body.clear();
+                putBE32(body, sequence++);
+                body.insert(body.end(), pending.data.begin(), pending.data.end());
+                chunk(out, "fdAT", body);
+            }
+        }
+        pending.data.clear();
+    }
+
+    Format format;
+    int w, h, frameMs;
+    unsigned colorBits;
+    std::vector<uint8_t> previous; // the last frame, w x h
+    std::vector<uint8_t> out;
+    Frame pending;
+    uint32_t frames = 0;
+    uint32_t sequence = 0;
+    size_t actlOffset = 0;
+};
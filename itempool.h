@@ -0,0 +1,185 @@
+// Food and power-ups on a board, as many at once as it has room for.
+//
+// Items are a structure of arrays, entry i of xs, ys and kinds being one
+// item, kept dense: taking an item moves the last one into its place. A hash
+// table from tile to entry finds the item under the head in O(1) however
+// many there are, so the board only has to mark the tile (FOOD, in
+// chunkboard.h's terms) and a step that lands on nothing never looks here.
+//
+// The table, TileMap, uses linear probing, is kept at most half full and
+// deletes by shifting later entries back, so there are no tombstones to
+// sweep up. It only allocates when it grows; reserve() the most expected.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum ItemKind : uint8_t { ITEM_FOOD, ITEM_SPEED, ITEM_SHRINK, ITEM_GHOST, ITEM_MAGNET, ITEM_KINDS };
+
+// A uint32_t per tile, for the few tiles of a large board that have one.
+class TileMap {
+public:
+    explicit TileMap(int boardWidth) : width(uint64_t(boardWidth)) { rehash(16); }
+
+    void reserve(size_t tiles) {
+        size_t want = slots.size();
+        while (tiles * 2 > want) want *= 2;
+        if (want != slots.size()) rehash(want);
+    }
+
+    size_t size() const { return used; }
+
+    // False, changing nothing, when the tile already has a value.
+    bool insert(int x, int y, uint32_t value) {
+        if ((used + 1) * 2 > slots.size()) rehash(slots.size() * 2);
+        uint64_t k = key(x, y);
+        size_t s = home(k);
+        for (; slots[s].used; s = (s + 1) & mask)
+            if (slots[s].key == k) return false;
+        slots[s] = {k, value, true};
+        used++;
+        return true;
+    }
+
+    // The tile's value, or nullptr.
+    uint32_t *find(int x, int y) {
+        size_t s = locate(key(x, y));
+        return s == NOWHERE ? nullptr : &slots[s].value;
+    }
+    const uint32_t *find(int x, int y) const { return const_cast<TileMap *>(this)->find(x, y); }
+
+    bool erase(int x, int y) {
+        size_t s = locate(key(x, y));
+        if (s == NOWHERE) return false;
+        // Later entries that may no longer be reachable past the gap move
+        // back into it.
+        size_t hole = s;
+        for (size_t j = (s + 1) & mask; slots[j].used; j = (j + 1) & mask) {
+            size_t h = home(slots[j].key);
+            if (((j - h) & mask) >= ((j - hole) & mask)) {
+                slots[hole] = slots[j];
+                hole = j;
+            }
+        }
+        slots[hole].used = false;
+        used--;
+        return true;
+    }
+
+    void clear() {
+        for (Slot &s : slots) s.used = false;
+        used = 0;
+    }
+
+private:
+    static const size_t NOWHERE = ~size_t(0);
+
+    struct Slot {
+        uint64_t key;
+        uint32_t value;
+        bool used;
+    };
+
+    uint64_t key(int x, int y) const { return uint64_t(y) * width + uint64_t(x); }
+    size_t home(uint64_t k) const { return size_t((k * 0x9e3779b97f4a7c15ull) >> shift); }
+
+    size_t locate(uint64_t k) const {
+        for (size_t s = home(k); slots[s].used; s = (s + 1) & mask)
+            if (slots[s].key == k) return s;
+        return NOWHERE;
+    }
+
+    // size is a power of two.
+    void rehash(size_t size) {
+        std::vector<Slot> old(size, Slot{0, 0, false});
+        old.swap(slots);
+        mask = size - 1;
+        shift = 64;
+        for (size_t n = size; n > 1; n >>= 1) shift--;
+        for (const Slot &o : old) {
+            if (!o.used) continue;
+            size_t s = home(o.key);
+            while (slots[s].used) s = (s + 1) & mask;
+            slots[s] = o;
+        }
+    }
+
+    uint64_t width;
+    std::vector<Slot> slots;
+    size_t used = 0;
+    size_t mask = 0;
+    int shift = 64;
+};
+
+class ItemPool {
+public:
+    static const uint32_t NONE = ~0u;
+
+    explicit ItemPool(int boardWidth) : entries(boardWidth) {}
+
+    void reserve(size_t items) {
+        xs.reserve(items);
+        ys.reserve(items);
+        kinds.reserve(items);
+        entries.reserve(items);
+    }
+
+    size_t size() const { return kinds.size(); }
+    size_t count(ItemKind kind) const { return counts[kind]; }
+
+    int x(uint32_t i) const { return xs[i]; }
+    int y(uint32_t i) const { return ys[i]; }
+    ItemKind kind(uint32_t i) const { return ItemKind(kinds[i]); }
+
+    // False when the tile already holds an item.
+    bool add(int x, int y, ItemKind kind) {
+        if (!entries.insert(x, y, uint32_t(kinds.size()))) return false;
+        xs.push_back(x);
+        ys.push_back(y);
+        kinds.push_back(kind);
+        counts[kind]++;
+        return true;
+    }
+
+    // The entry of the item on (x, y), or NONE.
+    uint32_t find(int x, int y) const {
+        const uint32_t *i = entries.find(x, y);
+        return i ? *i : NONE;
+    }
+
+    // Removes the item on (x, y) and says what it was; false if there is none.
+    bool take(int x, int y, ItemKind &kind) {
+        uint32_t i = find(x, y);
+        if (i == NONE) return false;
+        kind = ItemKind(kinds[i]);
+        counts[kind]--;
+        entries.erase(x, y);
+
+        uint32_t last = uint32_t(kinds.size() - 1);
+        if (i != last) {
+            xs[i] = xs[last];
+            ys[i] = ys[last];
+            kinds[i] = kinds[last];
+            *entries.find(xs[i], ys[i]) = i;
+        }
+        xs.pop_back();
+        ys.pop_back();
+        kinds.pop_back();
+        return true;
+    }
+
+    void clear() {
+        xs.clear();
+        ys.clear();
+        kinds.clear();
+        entries.clear();
+        for (size_t &c : counts) c = 0;
+    }
+
+private:
+    std::vector<int32_t> xs, ys;
+    std::vector<uint8_t> kinds;
+    size_t counts[ITEM_KINDS] = {};
+    TileMap entries; // tile to index in xs, ys and kinds
+};
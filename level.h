@@ -0,0 +1,309 @@
+// Levels: walls, spawn points and food regions in a binary file that is used
+// straight from a memory mapping.
+//
+// A file is a LevelHeader and three tables at the offsets it gives, each
+// 8-byte aligned:
+//
+//   walls  rows x wordsPerRow uint64_t; bit x % 64 of word x / 64 of a row
+//          is set where there is a wall
+//   spawns spawnCount LevelSpawn
+//   food   foodRegionCount LevelRect, the areas food is placed in (none
+//          means anywhere open)
+//
+// Everything is little-endian and read in place, so nothing is parsed:
+// opening a level checks that the header and the tables fit the file and
+// that the spawns and food regions are on the board, and a 4096 x 4096 level
+// (2 MB of walls) is usable as soon as it is mapped, its pages read in as
+// they are touched. openLevel() keeps one mapping per path, so every game in
+// a process shares the same pages.
+//
+// levelconv.cpp makes level files from ASCII art; see parseAsciiLevel().
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct LevelHeader {
+    char magic[4]; // "SNLV"
+    uint32_t version;
+    uint32_t cols, rows;
+    uint32_t wordsPerRow;
+    uint32_t spawnCount, foodRegionCount;
+    uint32_t reserved;
+    uint64_t wallsOffset, spawnsOffset, foodOffset;
+};
+
+// A start tile and the direction the snake sets off in.
+struct LevelSpawn {
+    int32_t x, y, dx, dy;
+};
+
+struct LevelRect {
+    int32_t x, y, w, h;
+};
+
+namespace levelformat {
+const char MAGIC[4] = {'S', 'N', 'L', 'V'};
+const uint32_t VERSION = 1;
+} // namespace levelformat
+
+// A level held in memory somewhere else: a mapped file, or encoded bytes.
+class Level {
+public:
+    // Points the level at data if it holds a whole level, on a board of at
+    // least one tile with every spawn and food region on it; nothing is
+    // copied.
+    bool view(const void *data, size_t size) {
+        using namespace levelformat;
+        const LevelHeader *h = static_cast<const LevelHeader *>(data);
+        if (size < sizeof(LevelHeader) || std::memcmp(h->magic, MAGIC, 4) != 0 || h->version != VERSION) return false;
+        if (h->cols == 0 || h->rows == 0 || h->cols > INT32_MAX || h->rows > INT32_MAX) return false;
+        if (h->wordsPerRow != (h->cols + 63) / 64) return false;
+        auto fits = [&](uint64_t offset, uint64_t bytes) { return offset % 8 == 0 && offset <= size && bytes <= size - offset; };
+        if (!fits(h->wallsOffset, uint64_t(h->rows) * h->wordsPerRow * 8) ||
+            !fits(h->spawnsOffset, uint64_t(h->spawnCount) * sizeof(LevelSpawn)) ||
+            !fits(h->foodOffset, uint64_t(h->foodRegionCount) * sizeof(LevelRect)))
+            return false;
+        const uint8_t *base = static_cast<const uint8_t *>(data);
+        const LevelSpawn *spawns = reinterpret_cast<const LevelSpawn *>(base + h->spawnsOffset);
+        const LevelRect *food = reinterpret_cast<const LevelRect *>(base + h->foodOffset);
+        // Games index the board with these unchecked, so they must be on it.
+        for (uint32_t i = 0; i < h->spawnCount; ++i)
+            if (uint32_t(spawns[i].x) >= h->cols || uint32_t(spawns[i].y) >= h->rows) return false;
+        for (uint32_t i = 0; i < h->foodRegionCount; ++i) {
+            const LevelRect &r = food[i];
+            if (r.x < 0 || r.y < 0 || r.w <= 0 || r.h <= 0 || int64_t(r.x) + r.w > int64_t(h->cols) ||
+                int64_t(r.y) + r.h > int64_t(h->rows))
+                return false;
+        }
+        header = h;
+        walls = reinterpret_cast<const uint64_t *>(base + h->wallsOffset);
+        spawnTable = spawns;
+        foodTable = food;
+        return true;
+    }
+
+    int cols() const { return int(header->cols); }
+    int rows() const { return int(header->rows); }
+    bool wall(int x, int y) const { return wallRow(y)[x >> 6] >> (x & 63) & 1; }
+    const uint64_t *wallRow(int y) const { return walls + size_t(y) * header->wordsPerRow; }
+    size_t wordsPerRow() const { return header->wordsPerRow; }
+
+    int spawnCount() const { return int(header->spawnCount); }
+    const LevelSpawn &spawn(int i) const { return spawnTable[i]; }
+    int foodRegionCount() const { return int(header->foodRegionCount); }
+    const LevelRect &foodRegion(int i) const { return foodTable[i]; }
+
+private:
+    const LevelHeader *header = nullptr;
+    const uint64_t *walls = nullptr;
+    const LevelSpawn *spawnTable = nullptr;
+    const LevelRect *foodTable = nullptr;
+};
+
+// A level file mapped read-only for as long as the object lives.
+class MappedLevel : public Level {
+public:
+    MappedLevel() = default;
+    ~MappedLevel() { close(); }
+
+    MappedLevel(const MappedLevel&) = delete;
+    MappedLevel& operator=(const MappedLevel&) = delete;
+
+    bool open(const char *path) {
+        close();
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER fileSize;
+        HANDLE mapping = GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0
+                             ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr)
+                             : nullptr;
+        if (mapping) data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (mapping) CloseHandle(mapping); // the view keeps the mapping alive
+        CloseHandle(file);
+        size = data ? size_t(fileSize.QuadPart) : 0;
+#else
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void *p = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            if (p != MAP_FAILED) data = p, size = size_t(st.st_size);
+        }
+        ::close(fd); // the mapping stays
+#endif
+        if (data && view(data, size)) return true;
+        close();
+        return false;
+    }
+
+    void close() {
+        if (!data) return;
+#if defined(_WIN32)
+        UnmapViewOfFile(data);
+#else
+        munmap(data, size);
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+private:
+    void *data = nullptr;
+    size_t size = 0;
+};
+
+// The level at path, mapped once however many games open it; nullptr if it
+// cannot be opened. The mapping goes away with the last reference.
+inline std::shared_ptr<const Level> openLevel(const std::string &path) {
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<MappedLevel>> mapped;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (std::shared_ptr<MappedLevel> level = mapped[path].lock()) return level;
+    auto level = std::make_shared<MappedLevel>();
+    if (!level->open(path.c_str())) return nullptr;
+    mapped[path] = level;
+    return level;
+}
+
+// A level being built, one byte per tile, before it is encoded.
+struct LevelData {
+    int cols = 0, rows = 0;
+    std::vector<uint8_t> walls; // rows x cols, nonzero for a wall
+    std::vector<LevelSpawn> spawns;
+    std::vector<LevelRect> food;
+};
+
+// The file for a level.
+inline std::vector<uint8_t> encodeLevel(const LevelData &level) {
+    auto align = [](size_t n) { return (n + 7) & ~size_t(7); };
+    LevelHeader h = {};
+    std::memcpy(h.magic, levelformat::MAGIC, 4);
+    h.version = levelformat::VERSION;
+    h.cols = uint32_t(level.cols);
+    h.rows = uint32_t(level.rows);
+    h.wordsPerRow = (h.cols + 63) / 64;
+    h.spawnCount = uint32_t(level.spawns.size());
+    h.foodRegionCount = uint32_t(level.food.size());
+    h.wallsOffset = align(sizeof h);
+    h.spawnsOffset = h.wallsOffset + uint64_t(h.rows) * h.wordsPerRow * 8;
+    h.foodOffset = align(h.spawnsOffset + level.spawns.size() * sizeof(LevelSpawn));
+
+    std::vector<uint8_t> out(align(h.foodOffset + level.food.size() * sizeof(LevelRect)));
+    std::memcpy(out.data(), &h, sizeof h);
+    uint64_t *walls = reinterpret_cast<uint64_t *>(out.data() + h.wallsOffset);
+    for (int y = 0; y < level.rows; ++y)
+        for (int x = 0; x < level.cols; ++x)
+            if (level.walls[size_t(y) * level.cols + x]) walls[size_t(y) * h.wordsPerRow + x / 64] |= uint64_t(1) << (x % 64);
+    if (!level.spawns.empty()) std::memcpy(out.data() + h.spawnsOffset, level.spawns.data(), level.spawns.size() * sizeof(LevelSpawn));
+    if (!level.food.empty()) std::memcpy(out.data() + h.foodOffset, level.food.data(), level.food.size() * sizeof(LevelRect));
+    return out;
+}
+
+// Reads the ASCII form of a level:
+//
+//   ; a comment
+//   food X Y W H      a food region, in tiles
+//   #######           map rows: '#' is wall, '.' or ' ' open, and > < ^ v
+//   #>....#           a spawn heading that way
+//
+// The board is as wide as the longest map row; shorter rows are open on the
+// right, and food regions must lie on it. Returns false, with the line in
+// error, for anything else.
+inline bool parseAsciiLevel(const std::string &text, LevelData &level, std::string &error) {
+    level = LevelData();
+    std::vector<std::string> map;
+    std::vector<size_t> foodLines;
+    size_t lineNumber = 0;
+    for (size_t start = 0; start < text.size();) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) end = text.size();
+        std::string line = text.substr(start, end - start);
+        start = end + 1;
+        lineNumber++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+
+        if (!line.empty() && line[0] == ';') continue;
+        if (line.compare(0, 5, "food ") == 0) {
+            LevelRect r;
+            if (std::sscanf(line.c_str() + 5, "%d %d %d %d", &r.x, &r.y, &r.w, &r.h) != 4 || r.w <= 0 || r.h <= 0) {
+                error = "line " + std::to_string(lineNumber) + ": expected food X Y W H";
+                return false;
+            }
+            level.food.push_back(r);
+            foodLines.push_back(lineNumber);
+            continue;
+        }
+        size_t bad = line.find_first_not_of("#. ><^v");
+        if (bad != std::string::npos) {
+            error = "line " + std::to_string(lineNumber) + ": unexpected '" + line[bad] + "'";
+            return false;
+        }
+        map.push_back(line);
+    }
+    while (!map.empty() && map.back().empty()) map.pop_back(); // trailing blank lines
+
+    level.rows = int(map.size());
+    for (const std::string &row : map) level.cols = std::max(level.cols, int(row.size()));
+    if (level.cols == 0 || level.rows == 0) {
+        error = "no map";
+        return false;
+    }
+    for (size_t i = 0; i < level.food.size(); ++i) {
+        const LevelRect &r = level.food[i];
+        if (r.x < 0 || r.y < 0 || r.x + int64_t(r.w) > level.cols || r.y + int64_t(r.h) > level.rows) {
+            error = "line " + std::to_string(foodLines[i]) + ": food region is off the map";
+            return false;
+        }
+    }
+    level.walls.assign(size_t(level.cols) * level.rows, 0);
+    for (int y = 0; y < level.rows; ++y)
+        for (int x = 0; x < int(map[y].size()); ++x) {
+            char c = map[y][x];
+            if (c == '#') level.walls[size_t(y) * level.cols + x] = 1;
+            else if (c == '>') level.spawns.push_back({x, y, 1, 0});
+            else if (c == '<') level.spawns.push_back({x, y, -1, 0});
+            else if (c == '^') level.spawns.push_back({x, y, 0, -1});
+            else if (c == 'v') level.spawns.push_back({x, y, 0, 1});
+        }
+    return true;
+}
+
+// The ASCII form of a level, which parseAsciiLevel() reads back.
+inline std::string formatAsciiLevel(const LevelData &level) {
+    std::string text;
+    for (const LevelRect &r : level.food)
+        text += "food " + std::to_string(r.x) + " " + std::to_string(r.y) + " " + std::to_string(r.w) + " " +
+                std::to_string(r.h) + "\n";
+    std::string map;
+    for (int y = 0; y < level.rows; ++y) {
+        for (int x = 0; x < level.cols; ++x) map += level.walls[size_t(y) * level.cols + x] ? '#' : '.';
+        map += '\n';
+    }
+    for (const LevelSpawn &s : level.spawns) {
+        if (unsigned(s.x) >= unsigned(level.cols) || unsigned(s.y) >= unsigned(level.rows)) continue;
+        char c = s.dx > 0 ? '>' : s.dx < 0 ? '<' : s.dy < 0 ? '^' : 'v';
+        map[size_t(s.y) * (level.cols + 1) + s.x] = c;
+    }
+    return text + map;
+}
@@ -0,0 +1,43 @@
+// Converts a level from ASCII art (see parseAsciiLevel() in level.h) to the
+// binary form games map with openLevel().
+//
+//   levelconv IN.txt OUT.lvl
+//
+// levels/a.txt and levels/b.txt are the boards of a.cpp and b.cpp.
+#include <cstdio>
+#include <string>
+#include "imageio.h"
+#include "level.h"
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: levelconv IN.txt OUT.lvl\n");
+        return 2;
+    }
+
+    FILE *in = std::fopen(argv[1], "rb");
+    if (!in) {
+        std::fprintf(stderr, "levelconv: cannot read %s\n", argv[1]);
+        return 1;
+    }
+    std::string text;
+    char buffer[65536];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof buffer, in)) > 0) text.append(buffer, n);
+    std::fclose(in);
+
+    LevelData level;
+    std::string error;
+    if (!parseAsciiLevel(text, level, error)) {
+        std::fprintf(stderr, "levelconv: %s: %s\n", argv[1], error.c_str());
+        return 1;
+    }
+    std::vector<uint8_t> file = encodeLevel(level);
+    if (!writeFile(argv[2], file)) {
+        std::fprintf(stderr, "levelconv: cannot write %s\n", argv[2]);
+        return 1;
+    }
+    std::printf("%s: %dx%d, %zu spawn point(s), %zu food region(s), %zu bytes\n", argv[2], level.cols, level.rows,
+                level.spawns.size(), level.food.size(), file.size());
+    return 0;
+}
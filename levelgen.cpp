@@ -0,0 +1,51 @@
+// Writes a generated level (see levelgen.h), as a level file or, for a .txt
+// name, as ASCII art to look at or edit and feed to levelconv.
+//
+//   levelgen pillars|rooms|maze ID OUT.lvl|OUT.txt [DENSITY [COLS ROWS]]
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "imageio.h"
+#include "levelgen.h"
+
+int main(int argc, char **argv) {
+    LevelParams params;
+    bool known = argc >= 4;
+    if (known) {
+        if (std::strcmp(argv[1], "pillars") == 0) params.style = LevelStyle::PILLARS;
+        else if (std::strcmp(argv[1], "rooms") == 0) params.style = LevelStyle::ROOMS;
+        else if (std::strcmp(argv[1], "maze") == 0) params.style = LevelStyle::MAZE;
+        else known = false;
+    }
+    if (!known || argc == 6 || argc > 7) {
+        std::fprintf(stderr, "usage: levelgen pillars|rooms|maze ID OUT.lvl|OUT.txt [DENSITY [COLS ROWS]]\n");
+        return 2;
+    }
+    uint64_t id = std::strtoull(argv[2], nullptr, 10);
+    if (argc > 4) params.density = std::atof(argv[4]);
+    if (argc > 5) {
+        params.cols = std::atoi(argv[5]);
+        params.rows = std::atoi(argv[6]);
+    }
+
+    LevelData level = generateLevel(params, id);
+    std::string out = argv[3];
+    bool ascii = out.size() > 4 && out.compare(out.size() - 4, 4, ".txt") == 0;
+    std::vector<uint8_t> file;
+    if (ascii) {
+        std::string text = formatAsciiLevel(level);
+        file.assign(text.begin(), text.end());
+    } else {
+        file = encodeLevel(level);
+    }
+    if (!writeFile(out.c_str(), file)) {
+        std::fprintf(stderr, "levelgen: cannot write %s\n", out.c_str());
+        return 1;
+    }
+    size_t walls = 0;
+    for (uint8_t w : level.walls) walls += w != 0;
+    std::printf("%s: %dx%d, %.0f%% wall, spawn %d,%d\n", out.c_str(), level.cols, level.rows,
+                100.0 * walls / level.walls.size(), level.spawns[0].x, level.spawns[0].y);
+    return 0;
+}
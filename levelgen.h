@@ -0,0 +1,265 @@
+// Procedural levels for training runs: obstacle layouts in the spirit of
+// a.cpp's bars and b.cpp's walls, from a style, a density and a seed.
+//
+// A level id is the seed. The generator draws from its own splitmix64 rather
+// than <random>'s distributions, whose results differ between standard
+// libraries, so an id gives the same level on every platform.
+//
+// Every level comes out with
+//   - every open tile reachable from the spawn: the spawn's region is flood
+//     filled and any pocket it does not reach becomes wall, and
+//   - a clear square around the spawn and a clear run ahead of it.
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "level.h"
+
+enum class LevelStyle { PILLARS, ROOMS, MAZE };
+
+struct LevelParams {
+    LevelStyle style = LevelStyle::PILLARS;
+    int cols = 54, rows = 36;
+    // PILLARS: share of the inside that is wall. ROOMS: from few large rooms
+    // (0) to many small ones (1). MAZE: share of the maze's inner walls kept;
+    // 1 is a maze with one way between any two places.
+    double density = 0.1;
+    bool border = true;  // a wall all round, as in b.cpp
+    int startRoom = 2;   // tiles kept clear on each side of the spawn
+    int runway = 6;      // tiles kept clear ahead of it
+    int corridor = 2;    // MAZE: width of a passage
+};
+
+class LevelGenerator {
+public:
+    // The level for seed, written over out so its storage is reused.
+    void generate(const LevelParams &params, uint64_t seed, LevelData &out) {
+        p = params;
+        p.cols = std::max(p.cols, 3);
+        p.rows = std::max(p.rows, 3);
+        state = seed;
+        level = &out;
+        out.cols = p.cols;
+        out.rows = p.rows;
+        out.walls.assign(size_t(p.cols) * p.rows, 0);
+        out.spawns.clear();
+        out.food.clear();
+
+        lo = p.border ? 1 : 0;
+        right = p.cols - 1 - lo;
+        bottom = p.rows - 1 - lo;
+        if (p.border) drawBorder();
+
+        LevelSpawn spawn = pickSpawn();
+        switch (p.style) {
+        case LevelStyle::PILLARS: pillars(); break;
+        case LevelStyle::ROOMS: rooms(); break;
+        case LevelStyle::MAZE: maze(); break;
+        }
+        clearStart(spawn);
+        fillPockets(spawn);
+
+        out.spawns.push_back(spawn);
+        out.food.push_back({lo, lo, right - lo + 1, bottom - lo + 1});
+    }
+
+private:
+    uint64_t next() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+    // 0 to n - 1; n > 0.
+    int below(int n) { return int(((next() >> 32) * uint64_t(n)) >> 32); }
+    int between(int a, int b) { return a + below(b - a + 1); }
+    bool chance(double share) { return below(1 << 16) < int(share * (1 << 16)); }
+
+    uint8_t &tile(int x, int y) { return level->walls[size_t(y) * p.cols + x]; }
+
+    // Sets a block of tiles, clipped to the board.
+    void fill(int x, int y, int w, int h, uint8_t wall) {
+        int x0 = std::max(x, 0), x1 = std::min(x + w, p.cols);
+        int y0 = std::max(y, 0), y1 = std::min(y + h, p.rows);
+        for (int ty = y0; ty < y1; ++ty)
+            for (int tx = x0; tx < x1; ++tx) tile(tx, ty) = wall;
+    }
+
+    // A random heading, and a tile with room for the start square and the
+    // runway; the middle when the board is too small for both.
+    LevelSpawn pickSpawn() {
+        static const int DIRS[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+        const int *d = DIRS[below(4)];
+        int r = p.startRoom, run = p.runway;
+        int x0 = lo + r + std::max(0, -d[0]) * run, x1 = right - r - std::max(0, d[0]) * run;
+        int y0 = lo + r + std::max(0, -d[1]) * run, y1 = bottom - r - std::max(0, d[1]) * run;
+        int x = x0 <= x1 ? between(x0, x1) : (lo + right) / 2;
+        int y = y0 <= y1 ? between(y0, y1) : (lo + bottom) / 2;
+        return {x, y, d[0], d[1]};
+    }
+
+    void drawBorder() {
+        fill(0, 0, p.cols, 1, 1);
+        fill(0, p.rows - 1, p.cols, 1, 1);
+        fill(0, 0, 1, p.rows, 1);
+        fill(p.cols - 1, 0, 1, p.rows, 1);
+    }
+
+    void clearStart(const LevelSpawn &s) {
+        int r = p.startRoom;
+        fill(s.x - r, s.y - r, 2 * r + 1, 2 * r + 1, 0);
+        for (int i = 1; i <= p.runway; ++i) {
+            int x = s.x + s.dx * i, y = s.y + s.dy * i;
+            if (x < lo || y < lo || x > right || y > bottom) break;
+            tile(x, y) = 0;
+        }
+        if (p.border) drawBorder(); // the square may have reached it
+    }
+
+    // Blocks and short bars, like a.cpp's, until the share of wall is met.
+    void pillars() {
+        int inside = (right - lo + 1) * (bottom - lo + 1);
+        int target = int(p.density * inside), placed = 0;
+        for (int attempt = 0; placed < target && attempt < 4 * inside; ++attempt) {
+            int w = 1 + below(2), h = 1 + below(2);
+            if (below(3) == 0) { // a bar
+                int length = between(3, 6);
+                if (below(2)) w = length, h = 1;
+                else w = 1, h = length;
+            }
+            int x = between(lo, right), y = between(lo, bottom);
+            for (int ty = y; ty < std::min(y + h, bottom + 1); ++ty)
+                for (int tx = x; tx < std::min(x + w, right + 1); ++tx) {
+                    placed += !tile(tx, ty);
+                    tile(tx, ty) = 1;
+                }
+        }
+    }
+
+    // Recursive division: each wall splits a room in two and has a door two
+    // tiles wide, so a later one-tile wall against it cannot close it.
+    void rooms() {
+        int minRoom = std::max(2, int(3 + (1 - p.density) * 12));
+        rects.clear();
+        rects.push_back({lo, lo, right - lo + 1, bottom - lo + 1});
+        while (!rects.empty()) {
+            Rect r = rects.back();
+            rects.pop_back();
+            bool canSplitRows = r.h >= 2 * minRoom + 1, canSplitCols = r.w >= 2 * minRoom + 1;
+            if (!canSplitRows && !canSplitCols) continue;
+            bool splitRows = canSplitRows && (!canSplitCols || r.h > r.w || (r.h == r.w && below(2)));
+            if (splitRows) {
+                int y = r.y + between(minRoom, r.h - minRoom - 1);
+                int door = r.x + below(r.w - 1);
+                fill(r.x, y, r.w, 1, 1);
+                fill(door, y, std::min(r.w, 2), 1, 0);
+                rects.push_back({r.x, r.y, r.w, y - r.y});
+                rects.push_back({r.x, y + 1, r.w, r.y + r.h - y - 1});
+            } else {
+                int x = r.x + between(minRoom, r.w - minRoom - 1);
+                int door = r.y + below(r.h - 1);
+                fill(x, r.y, 1, r.h, 1);
+                fill(x, door, 1, std::min(r.h, 2), 0);
+                rects.push_back({r.x, r.y, x - r.x, r.h});
+                rects.push_back({x + 1, r.y, r.x + r.w - x - 1, r.h});
+            }
+        }
+    }
+
+    // Cells of corridor x corridor tiles with one-tile walls between them,
+    // joined by a depth-first walk; then a share of the walls left standing
+    // is knocked through so the maze has loops.
+    void maze() {
+        int c = std::max(p.corridor, 1), pitch = c + 1;
+        int cellsX = (right - lo + 2) / pitch, cellsY = (bottom - lo + 2) / pitch;
+        fill(lo, lo, right - lo + 1, bottom - lo + 1, 1);
+        if (cellsX <= 0 || cellsY <= 0) return;
+        auto cellX = [&](int i) { return lo + i * pitch; };
+        auto cellY = [&](int j) { return lo + j * pitch; };
+
+        visited.assign(size_t(cellsX) * cellsY, 0);
+        stack.clear();
+        int startCell = below(cellsX * cellsY);
+        visited[startCell] = 1;
+        stack.push_back(uint32_t(startCell));
+        fill(cellX(startCell % cellsX), cellY(startCell / cellsX), c, c, 0);
+        static const int DIRS[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+        while (!stack.empty()) {
+            int cell = int(stack.back());
+            int i = cell % cellsX, j = cell / cellsX;
+            int options[4], n = 0;
+            for (int d = 0; d < 4; ++d) {
+                int ni = i + DIRS[d][0], nj = j + DIRS[d][1];
+                if (ni >= 0 && nj >= 0 && ni < cellsX && nj < cellsY && !visited[size_t(nj) * cellsX + ni]) options[n++] = d;
+            }
+            if (n == 0) {
+                stack.pop_back();
+                continue;
+            }
+            int d = options[below(n)];
+            int ni = i + DIRS[d][0], nj = j + DIRS[d][1];
+            visited[size_t(nj) * cellsX + ni] = 1;
+            stack.push_back(uint32_t(nj * cellsX + ni));
+            // The new cell and the wall between, as one block.
+            int x0 = std::min(cellX(i), cellX(ni)), y0 = std::min(cellY(j), cellY(nj));
+            fill(x0, y0, c + std::abs(ni - i) * pitch, c + std::abs(nj - j) * pitch, 0);
+        }
+
+        double knock = 1 - p.density;
+        for (int j = 0; j < cellsY; ++j)
+            for (int i = 0; i < cellsX; ++i) {
+                if (i + 1 < cellsX && chance(knock)) fill(cellX(i) + c, cellY(j), 1, c, 0);
+                if (j + 1 < cellsY && chance(knock)) fill(cellX(i), cellY(j) + c, c, 1, 0);
+            }
+
+        // Tiles past the last cells, fewer than a cell's worth, widen them.
+        int edgeX = cellX(cellsX - 1) + c - 1, edgeY = cellY(cellsY - 1) + c - 1;
+        for (int y = lo; y <= bottom; ++y)
+            for (int x = edgeX + 1; x <= right; ++x) tile(x, y) = tile(edgeX, y);
+        for (int y = edgeY + 1; y <= bottom; ++y)
+            for (int x = lo; x <= right; ++x) tile(x, y) = tile(x, edgeY);
+    }
+
+    // Open tiles the spawn cannot reach become wall.
+    void fillPockets(const LevelSpawn &s) {
+        size_t cells = level->walls.size();
+        visited.assign(cells, 0);
+        stack.clear();
+        stack.push_back(uint32_t(size_t(s.y) * p.cols + s.x));
+        visited[stack.back()] = 1;
+        while (!stack.empty()) {
+            uint32_t i = stack.back();
+            stack.pop_back();
+            int x = int(i % p.cols), y = int(i / p.cols);
+            auto visit = [&](bool inside, uint32_t n) {
+                if (inside && !visited[n] && !level->walls[n]) {
+                    visited[n] = 1;
+                    stack.push_back(n);
+                }
+            };
+            visit(x > 0, i - 1);
+            visit(x + 1 < p.cols, i + 1);
+            visit(y > 0, i - p.cols);
+            visit(y + 1 < p.rows, i + p.cols);
+        }
+        for (size_t i = 0; i < cells; ++i) level->walls[i] |= !visited[i];
+    }
+
+    struct Rect { int x, y, w, h; };
+
+    LevelParams p;
+    uint64_t state = 0;
+    LevelData *level = nullptr;
+    int lo = 0, right = 0, bottom = 0; // the inside, inclusive
+    std::vector<Rect> rects;
+    std::vector<uint8_t> visited;
+    std::vector<uint32_t> stack;
+};
+
+inline LevelData generateLevel(const LevelParams &params, uint64_t seed) {
+    LevelData level;
+    LevelGenerator().generate(params, seed, level);
+    return level;
+}
@@ -0,0 +1,133 @@
+// Minimap for the giant board, kept current incrementally.
+//
+// The board is summarised in a pyramid of occupancy counts. Level 0 has one
+// cell per (1 << baseShift) x (1 << baseShift) block of tiles and every
+// level above halves the resolution. A changed tile updates one cell per
+// level and queues those cells as dirty; upload() then writes just the dirty
+// pixels of one level to its texture with SDL_UpdateTexture. The work per
+// frame is proportional to the tiles that changed, not to the board area.
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+#include "chunkboard.h"
+
+class Minimap : public TileObserver {
+public:
+    // Chooses baseShift so level 0 is at most maxSize pixels on each side.
+    Minimap(const ChunkedBoard& board, int maxSize, int levelCount) {
+        int shift = 0;
+        while ((board.width() >> shift) > maxSize || (board.height() >> shift) > maxSize) ++shift;
+        for (int i = 0; i < levelCount; ++i) {
+            Level l;
+            l.shift = shift + i;
+            l.w = ((board.width() - 1) >> l.shift) + 1;
+            l.h = ((board.height() - 1) >> l.shift) + 1;
+            l.cells.resize(l.w * l.h);
+            l.dirty.resize(l.w * l.h, 0);
+            levels.push_back(std::move(l));
+            if (levels.back().w == 1 && levels.back().h == 1) break;
+        }
+        build(board);
+    }
+
+    ~Minimap() {
+        for (auto& l : levels)
+            if (l.texture) SDL_DestroyTexture(l.texture);
+    }
+
+    Minimap(const Minimap&) = delete;
+    Minimap& operator=(const Minimap&) = delete;
+
+    int levelCount() const { return static_cast<int>(levels.size()); }
+    int width(int level) const { return levels[level].w; }
+    int height(int level) const { return levels[level].h; }
+    int shift(int level) const { return levels[level].shift; }
+
+    void tileChanged(int x, int y, Tile from, Tile to) override {
+        for (auto& l : levels) {
+            int i = (y >> l.shift) * l.w + (x >> l.shift);
+            Counts& c = l.cells[i];
+            if (from != EMPTY) c.count[from]--;
+            if (to != EMPTY) c.count[to]++;
+            if (!l.dirty[i]) {
+                l.dirty[i] = 1;
+                l.dirtyCells.push_back(i);
+            }
+        }
+    }
+
+    // Brings the level's texture up to date and returns it. The first call
+    // for a level uploads the whole level; later calls upload dirty pixels.
+    SDL_Texture* upload(SDL_Renderer* renderer, int level) {
+        Level& l = levels[level];
+        if (!l.texture) {
+            l.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, l.w, l.h);
+            std::vector<uint32_t> pixels(l.w * l.h);
+            for (int i = 0; i < l.w * l.h; ++i) {
+                pixels[i] = color(l.cells[i]);
+                l.dirty[i] = 0;
+            }
+            l.dirtyCells.clear();
+            SDL_UpdateTexture(l.texture, nullptr, pixels.data(), l.w * 4);
+            lastUpload = pixels.size();
+            return l.texture;
+        }
+
+        for (int i : l.dirtyCells) {
+            uint32_t pixel = color(l.cells[i]);
+            SDL_Rect r = {i % l.w, i / l.w, 1, 1};
+            SDL_UpdateTexture(l.texture, &r, &pixel, 4);
+            l.dirty[i] = 0;
+        }
+        size_t uploaded = l.dirtyCells.size();
+        l.dirtyCells.clear();
+        lastUpload = uploaded;
+        return l.texture;
+    }
+
+    size_t lastUploadPixels() const { return lastUpload; }
+
+private:
+    struct Counts {
+        uint32_t count[4] = {0, 0, 0, 0}; // indexed by Tile; EMPTY is not counted
+    };
+
+    struct Level {
+        int shift, w, h;
+        std::vector<Counts> cells;
+        std::vector<uint8_t> dirty;
+        std::vector<int> dirtyCells;
+        SDL_Texture* texture = nullptr;
+    };
+
+    // One-time full build, visiting allocated chunks only.
+    void build(const ChunkedBoard& board) {
+        for (int cy = 0; cy < board.chunkRows(); ++cy) {
+            for (int cx = 0; cx < board.chunkColumns(); ++cx) {
+                const ChunkedBoard::Chunk* chunk = board.chunk(cx, cy);
+                if (!chunk || chunk->nonEmpty == 0) continue;
+                for (int ty = 0; ty < ChunkedBoard::CHUNK; ++ty) {
+                    for (int tx = 0; tx < ChunkedBoard::CHUNK; ++tx) {
+                        Tile t = Tile(chunk->tiles[ty * ChunkedBoard::CHUNK + tx]);
+                        if (t == EMPTY) continue;
+                        int x = (cx << ChunkedBoard::CHUNK_SHIFT) + tx, y = (cy << ChunkedBoard::CHUNK_SHIFT) + ty;
+                        for (auto& l : levels) l.cells[(y >> l.shift) * l.w + (x >> l.shift)].count[t]++;
+                    }
+                }
+            }
+        }
+    }
+
+    // Food beats snake beats wall; walls shade by how much of the cell they fill.
+    uint32_t color(const Counts& c) const {
+        if (c.count[FOOD]) return 0xffff4040;
+        if (c.count[SNAKE]) return 0xff40ff40;
+        if (c.count[WALL]) return 0xff005046 + (c.count[WALL] > 8 ? 0x00204020 : 0);
+        return 0xff101010;
+    }
+
+    std::vector<Level> levels;
+    size_t lastUpload = 0;
+};
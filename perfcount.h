@@ -0,0 +1,128 @@
+// Hardware performance counters (cycles, instructions, cache misses, branch
+// misses) for the calling thread via Linux perf_event_open.
+//
+// Counters are optional: on other platforms, inside containers without the
+// syscall, or when perf_event_paranoid forbids it, available() is false,
+// reason() says why and read() returns zeros.
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+struct PerfSample {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cacheMisses = 0;
+    uint64_t branchMisses = 0;
+
+    PerfSample operator-(const PerfSample& o) const {
+        PerfSample d;
+        d.cycles = cycles - o.cycles;
+        d.instructions = instructions - o.instructions;
+        d.cacheMisses = cacheMisses - o.cacheMisses;
+        d.branchMisses = branchMisses - o.branchMisses;
+        return d;
+    }
+
+    PerfSample& operator+=(const PerfSample& o) {
+        cycles += o.cycles;
+        instructions += o.instructions;
+        cacheMisses += o.cacheMisses;
+        branchMisses += o.branchMisses;
+        return *this;
+    }
+};
+
+class PerfCounters {
+public:
+    enum { CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES, COUNT };
+
+#ifdef __linux__
+    PerfCounters() {
+        static const uint64_t configs[COUNT] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (int i = 0; i < COUNT; ++i) {
+            fds[i] = -1;
+            slot[i] = -1;
+        }
+
+        // cycles leads the group; the rest are optional members, since some
+        // virtual machines expose only a subset of the hardware events.
+        int opened = 0;
+        for (int i = 0; i < COUNT; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof attr);
+            attr.size = sizeof attr;
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[i];
+            attr.disabled = i == 0;
+            attr.exclude_kernel = 1; // allowed at perf_event_paranoid <= 2
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+
+            int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds[0], 0));
+            if (fd < 0) {
+                if (i == 0) {
+                    why = errno == EACCES || errno == EPERM ? "not permitted (see /proc/sys/kernel/perf_event_paranoid)"
+                          : errno == ENOSYS                 ? "perf_event_open is not available"
+                          : errno == ENOENT || errno == EOPNOTSUPP ? "no hardware counters (virtual machine?)"
+                                                                   : std::strerror(errno);
+                    return;
+                }
+                continue;
+            }
+            fds[i] = fd;
+            slot[i] = opened++;
+        }
+        members = opened;
+        ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    ~PerfCounters() {
+        for (int i = COUNT - 1; i >= 0; --i)
+            if (fds[i] >= 0) close(fds[i]);
+    }
+
+    bool available() const { return fds[0] >= 0; }
+    bool has(int counter) const { return fds[counter] >= 0; }
+    const char* reason() const { return why; }
+
+    // Running totals since construction; subtract two reads for a phase.
+    PerfSample read() const {
+        PerfSample s;
+        if (!available()) return s;
+        uint64_t buf[1 + COUNT] = {};
+        if (::read(fds[0], buf, sizeof(uint64_t) * (1 + members)) <= 0) return s;
+        uint64_t* values = buf + 1; // buf[0] is the number of members
+        if (slot[CYCLES] >= 0) s.cycles = values[slot[CYCLES]];
+        if (slot[INSTRUCTIONS] >= 0) s.instructions = values[slot[INSTRUCTIONS]];
+        if (slot[CACHE_MISSES] >= 0) s.cacheMisses = values[slot[CACHE_MISSES]];
+        if (slot[BRANCH_MISSES] >= 0) s.branchMisses = values[slot[BRANCH_MISSES]];
+        return s;
+    }
+
+private:
+    int fds[COUNT];
+    int slot[COUNT]; // position of each counter in the group read
+    int members = 0;
+    const char* why = "";
+#else
+    PerfCounters() {}
+    bool available() const { return false; }
+    bool has(int) const { return false; }
+    const char* reason() const { return "perf_event_open is Linux-only"; }
+    PerfSample read() const { return PerfSample(); }
+#endif
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+};
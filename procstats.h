@@ -0,0 +1,34 @@
+// Process-wide numbers for startup reports.
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX // windows.h's min and max macros break std::min and std::max
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
+
+// Bytes of the process currently in RAM (working set on Windows), or 0 when
+// the platform does not say.
+inline size_t residentBytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof counters)) return counters.WorkingSetSize;
+    return 0;
+#elif defined(__linux__)
+    FILE *f = std::fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    unsigned long pages = 0, resident = 0;
+    int n = std::fscanf(f, "%lu %lu", &pages, &resident);
+    std::fclose(f);
+    return n == 2 ? resident * size_t(sysconf(_SC_PAGESIZE)) : 0;
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,304 @@
+// Recorded games of b.cpp (`b --record FILE`), played back by replay2video.
+//
+// A replay is a header followed by one record per frame. Every
+// keyframeInterval-th frame is a keyframe holding the whole state. The frames
+// in between hold what changed since the previous frame: the new head, how
+// much of the old body was kept, any segments appended at the tail, and the
+// food, bonus food and score when they change. A keyframe and the deltas
+// after it decode without anything earlier, so a replay splits into segments
+// that can be rendered in parallel.
+//
+// All numbers are little-endian; positions are 16-bit pixel coordinates.
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+struct ReplayState {
+    std::vector<SDL_Rect> body; // head first
+    SDL_Rect food = {0, 0, 0, 0};
+    bool bonusActive = false;
+    SDL_Rect bonusFood = {0, 0, 0, 0};
+    int score = 0;
+};
+
+namespace replayformat {
+
+const char MAGIC[4] = {'S', 'N', 'R', 'P'};
+const uint32_t VERSION = 1;
+const uint8_t KEYFRAME = 'K', DELTA = 'D';
+enum DeltaFlags : uint8_t { NEW_HEAD = 1, FOOD_MOVED = 2, BONUS_CHANGED = 4, SCORE_CHANGED = 8 };
+
+inline void put8(std::vector<uint8_t> &out, unsigned v) { out.push_back(static_cast<uint8_t>(v)); }
+inline void put16(std::vector<uint8_t> &out, unsigned v) {
+    out.push_back(static_cast<uint8_t>(v));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+}
+inline void put32(std::vector<uint8_t> &out, uint32_t v) {
+    put16(out, v & 0xffff);
+    put16(out, v >> 16);
+}
+inline void putPoint(std::vector<uint8_t> &out, const SDL_Rect &r) {
+    put16(out, static_cast<uint16_t>(r.x));
+    put16(out, static_cast<uint16_t>(r.y));
+}
+
+inline void putHeader(std::vector<uint8_t> &out, int width, int height, int tileSize, int fps, int keyframeInterval) {
+    out.insert(out.end(), MAGIC, MAGIC + 4);
+    put32(out, VERSION);
+    put16(out, width);
+    put16(out, height);
+    put16(out, tileSize);
+    put16(out, fps);
+    put16(out, keyframeInterval);
+}
+
+inline bool samePlace(const SDL_Rect &a, const SDL_Rect &b) { return a.x == b.x && a.y == b.y; }
+
+// Bounds-checked reading; a short read sets ok to false and returns zeros.
+struct Cursor {
+    const uint8_t *p, *end;
+    bool ok = true;
+
+    bool has(size_t n) {
+        if (size_t(end - p) < n) ok = false;
+        return ok;
+    }
+    unsigned get8() { return has(1) ? *p++ : 0; }
+    unsigned get16() {
+        if (!has(2)) return 0;
+        unsigned v = p[0] | p[1] << 8;
+        p += 2;
+        return v;
+    }
+    uint32_t get32() {
+        uint32_t lo = get16();
+        return lo | uint32_t(get16()) << 16;
+    }
+    int getCoord() { return static_cast<int16_t>(get16()); }
+    SDL_Rect getTile(int tile) {
+        int x = getCoord();
+        return {x, getCoord(), tile, tile};
+    }
+};
+
+} // namespace replayformat
+
+// Turns successive states into records. Used by ReplayWriter for files and
+// by ClipRecorder (clip.h) for the in-memory capture ring.
+class ReplayEncoder {
+public:
+    // Appends the record for the next frame to out. The first frame must be
+    // a keyframe.
+    void encode(std::vector<uint8_t> &out, const ReplayState &s, bool keyframe) {
+        if (keyframe) writeKeyframe(out, s);
+        else writeDelta(out, s);
+        previous.body.assign(s.body.begin(), s.body.end());
+        previous.food = s.food;
+        previous.bonusActive = s.bonusActive;
+        previous.bonusFood = s.bonusFood;
+        previous.score = s.score;
+        frames++;
+    }
+
+    uint32_t frameCount() const { return frames; }
+
+private:
+    void writeKeyframe(std::vector<uint8_t> &record, const ReplayState &s) {
+        using namespace replayformat;
+        put8(record, KEYFRAME);
+        put32(record, frames);
+        put32(record, static_cast<uint32_t>(s.score));
+        putPoint(record, s.food);
+        put8(record, s.bonusActive);
+        putPoint(record, s.bonusFood);
+        put16(record, static_cast<unsigned>(s.body.size()));
+        for (const SDL_Rect &r : s.body) putPoint(record, r);
+    }
+
+    // The new body is [head] + the first `kept` old segments + appended ones.
+    void writeDelta(std::vector<uint8_t> &record, const ReplayState &s) {
+        using namespace replayformat;
+        const std::vector<SDL_Rect> &old = previous.body;
+        bool newHead = !s.body.empty() && (old.empty() || !samePlace(s.body[0], old[0]));
+        size_t from = newHead ? 1 : 0, kept = 0;
+        while (from + kept < s.body.size() && kept < old.size() && samePlace(s.body[from + kept], old[kept])) ++kept;
+
+        uint8_t flags = (newHead ? NEW_HEAD : 0) | (samePlace(s.food, previous.food) ? 0 : FOOD_MOVED) |
+                        (s.bonusActive == previous.bonusActive && samePlace(s.bonusFood, previous.bonusFood) ? 0 : BONUS_CHANGED) |
+                        (s.score == previous.score ? 0 : SCORE_CHANGED);
+        put8(record, DELTA);
+        put8(record, flags);
+        if (newHead) putPoint(record, s.body[0]);
+        put16(record, static_cast<unsigned>(kept));
+        put16(record, static_cast<unsigned>(s.body.size() - from - kept));
+        for (size_t i = from + kept; i < s.body.size(); ++i) putPoint(record, s.body[i]);
+        if (flags & FOOD_MOVED) putPoint(record, s.food);
+        if (flags & BONUS_CHANGED) {
+            put8(record, s.bonusActive);
+            putPoint(record, s.bonusFood);
+        }
+        if (flags & SCORE_CHANGED) put32(record, static_cast<uint32_t>(s.score));
+    }
+
+    uint32_t frames = 0;
+    ReplayState previous;
+};
+
+class ReplayWriter {
+public:
+    ReplayWriter() = default;
+    ~ReplayWriter() { close(); }
+
+    ReplayWriter(const ReplayWriter&) = delete;
+    ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+    bool open(const char *path, int width, int height, int tileSize, int fps, int keyframeInterval = 64) {
+        close();
+        file = std::fopen(path, "wb");
+        if (!file) return false;
+        interval = keyframeInterval;
+        encoder = ReplayEncoder();
+        record.clear();
+        replayformat::putHeader(record, width, height, tileSize, fps, keyframeInterval);
+        std::fwrite(record.data(), 1, record.size(), file);
+        return true;
+    }
+
+    bool isOpen() const { return file != nullptr; }
+
+    // Appends the state shown in the next frame.
+    void frame(const ReplayState &s) {
+        if (!file) return;
+        record.clear();
+        encoder.encode(record, s, encoder.frameCount() % interval == 0);
+        std::fwrite(record.data(), 1, record.size(), file);
+    }
+
+    void close() {
+        if (file) std::fclose(file);
+        file = nullptr;
+    }
+
+private:
+    FILE *file = nullptr;
+    int interval = 64;
+    ReplayEncoder encoder;
+    std::vector<uint8_t> record; // reused for every frame
+};
+
+// A replay loaded into memory and indexed by keyframe.
+class Replay {
+public:
+    struct Segment {
+        size_t offset;     // of the keyframe record
+        size_t firstFrame;
+        size_t frames;
+    };
+
+    bool load(const char *path) {
+        FILE *f = std::fopen(path, "rb");
+        if (!f) return false;
+        std::vector<uint8_t> bytes;
+        uint8_t buffer[65536];
+        size_t n;
+        while ((n = std::fread(buffer, 1, sizeof buffer, f)) > 0) bytes.insert(bytes.end(), buffer, buffer + n);
+        std::fclose(f);
+        return parse(std::move(bytes));
+    }
+
+    // Indexes a whole replay held in memory. A record cut off at the end (the
+    // game was killed mid-write) is dropped.
+    bool parse(std::vector<uint8_t> bytes) {
+        using namespace replayformat;
+        data = std::move(bytes);
+        Cursor c = {data.data(), data.data() + data.size()};
+        if (!c.has(4) || !std::equal(MAGIC, MAGIC + 4, c.p)) return false;
+        c.p += 4;
+        if (c.get32() != VERSION) return false;
+        width = c.get16();
+        height = c.get16();
+        tileSize = c.get16();
+        fps = c.get16();
+        c.get16(); // keyframe interval, implied by the records
+        if (!c.ok) return false;
+
+        segments.clear();
+        frames = 0;
+        ReplayState scratch;
+        while (c.p < c.end) {
+            size_t offset = c.p - data.data();
+            bool keyframe = c.p[0] == KEYFRAME;
+            if (!keyframe && segments.empty()) return false;
+            if (!readRecord(c, scratch) || !c.ok) break;
+            if (keyframe) segments.push_back({offset, frames, 0});
+            segments.back().frames++;
+            frames++;
+        }
+        return true;
+    }
+
+    // Decodes one record into state, which must hold the previous frame for
+    // a delta. Returns false on a malformed record.
+    bool readRecord(replayformat::Cursor &c, ReplayState &state) const {
+        using namespace replayformat;
+        unsigned kind = c.get8();
+        if (kind == KEYFRAME) {
+            c.get32(); // frame number
+            state.score = static_cast<int>(c.get32());
+            state.food = c.getTile(tileSize);
+            state.bonusActive = c.get8() != 0;
+            state.bonusFood = c.getTile(tileSize);
+            unsigned length = c.get16();
+            if (!c.has(size_t(length) * 4)) return false;
+            state.body.resize(length);
+            for (SDL_Rect &r : state.body) r = c.getTile(tileSize);
+            return true;
+        }
+        if (kind != DELTA) return false;
+
+        unsigned flags = c.get8();
+        SDL_Rect head = flags & NEW_HEAD ? c.getTile(tileSize) : SDL_Rect{};
+        unsigned kept = c.get16(), appended = c.get16();
+        if (kept > state.body.size() || !c.has(size_t(appended) * 4)) return false;
+        state.body.resize(kept);
+        if (flags & NEW_HEAD) state.body.insert(state.body.begin(), head);
+        for (unsigned i = 0; i < appended; ++i) state.body.push_back(c.getTile(tileSize));
+        if (flags & FOOD_MOVED) state.food = c.getTile(tileSize);
+        if (flags & BONUS_CHANGED) {
+            state.bonusActive = c.get8() != 0;
+            state.bonusFood = c.getTile(tileSize);
+        }
+        if (flags & SCORE_CHANGED) state.score = static_cast<int>(c.get32());
+        return c.ok;
+    }
+
+    // Reads the frames of one segment in order, starting at its keyframe.
+    class Reader {
+    public:
+        Reader(const Replay &replay, const Segment &segment)
+            : replay(replay), cursor{replay.data.data() + segment.offset, replay.data.data() + replay.data.size()},
+              left(segment.frames) {}
+
+        bool next(ReplayState &state) {
+            if (left == 0) return false;
+            left--;
+            return replay.readRecord(cursor, state);
+        }
+
+    private:
+        const Replay &replay;
+        replayformat::Cursor cursor;
+        size_t left;
+    };
+
+    int width = 0, height = 0, tileSize = 0, fps = 0;
+    size_t frames = 0;
+    std::vector<Segment> segments;
+
+private:
+    std::vector<uint8_t> data;
+};
@@ -0,0 +1,223 @@
+// Renders a replay recorded with `b --record` to video, without a display.
+//
+//   replay2video [-j JOBS] [--scale N] [--font PATH] --y4m OUT.y4m REPLAY
+//   replay2video [-j JOBS] [--scale N] [--font PATH] --png DIR REPLAY
+//
+// The replay is cut into segments at its keyframes. Worker threads claim
+// segments in order, rasterize their frames into their own framebuffers with
+// softraster.h and encode them; the main thread writes the encoded frames in
+// order through a bounded reorder buffer. --scale enlarges frames by a whole
+// factor (3 gives 3240x2160). The score is drawn with the glyphs baked into
+// font_arial28.h; --font adds a TrueType fallback for anything they lack.
+#define SDL_MAIN_HANDLED
+#define SNAKE_NO_MAIN
+#include "b.cpp"
+#include "imageio.h"
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+// Encoded frames waiting to be written. Workers may run at most `window`
+// frames ahead of the writer; the worker holding the oldest unwritten frame
+// is never blocked, so the pipeline always makes progress.
+class ReorderBuffer {
+public:
+    explicit ReorderBuffer(size_t window) : window(window) {}
+
+    // Returns false after fail(), when the frame is not wanted and the worker
+    // should stop.
+    bool put(size_t frame, std::vector<uint8_t> bytes) {
+        std::unique_lock<std::mutex> lock(mutex);
+        space.wait(lock, [&] { return frame < next + window || failed; });
+        if (failed) return false;
+        frames.emplace(frame, std::move(bytes));
+        ready.notify_all();
+        return true;
+    }
+
+    // Waits for the next frame in order. Returns false after fail().
+    bool take(std::vector<uint8_t> &bytes) {
+        std::unique_lock<std::mutex> lock(mutex);
+        ready.wait(lock, [&] { return frames.count(next) || failed; });
+        if (failed) return false;
+        auto it = frames.find(next);
+        bytes.swap(it->second);
+        frames.erase(it);
+        next++;
+        space.notify_all();
+        return true;
+    }
+
+    void fail() {
+        std::lock_guard<std::mutex> lock(mutex);
+        failed = true;
+        ready.notify_all();
+        space.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable ready, space;
+    std::map<size_t, std::vector<uint8_t>> frames;
+    size_t next = 0;
+    size_t window;
+    bool failed = false;
+};
+
+struct Options {
+    int jobs = 0;
+    int scale = 1;
+    const char *font = nullptr;
+    const char *y4m = nullptr;
+    const char *pngDir = nullptr;
+    const char *replay = nullptr;
+};
+
+[[noreturn]] static void usage() {
+    std::fprintf(stderr, "usage: replay2video [-j JOBS] [--scale N] [--font PATH] (--y4m OUT.y4m | --png DIR) REPLAY\n");
+    std::exit(2);
+}
+
+static Options parseOptions(int argc, char **argv) {
+    Options o;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "-j" && hasValue) o.jobs = std::atoi(argv[++i]);
+        else if (arg == "--scale" && hasValue) o.scale = std::atoi(argv[++i]);
+        else if (arg == "--font" && hasValue) o.font = argv[++i];
+        else if (arg == "--y4m" && hasValue) o.y4m = argv[++i];
+        else if (arg == "--png" && hasValue) o.pngDir = argv[++i];
+        else if (arg[0] != '-' && !o.replay) o.replay = argv[i];
+        else usage();
+    }
+    if (!o.replay || !o.y4m == !o.pngDir || o.scale < 1) usage();
+    if (o.jobs <= 0) o.jobs = std::max(1u, std::thread::hardware_concurrency());
+    return o;
+}
+
+// Everything one worker owns: framebuffers, text renderer and score label.
+struct Worker {
+    SoftFramebuffer frame;
+    SoftFramebuffer scaled;
+    TextRenderer text;
+    ScoreLabel label;
+
+    Worker(const Replay &replay, int scale, const char *fallbackFont)
+        : frame(replay.width, replay.height, scale > 1 ? SoftFramebuffer::INDEXED8 : SoftFramebuffer::RGBA32),
+          scaled(scale > 1 ? replay.width * scale : 0, scale > 1 ? replay.height * scale : 0, SoftFramebuffer::RGBA32),
+          text(bakedfonts::arial28, fallbackFont) {}
+
+    // Draws one frame and returns the RGBA32 framebuffer holding it.
+    const SoftFramebuffer &draw(const ReplayState &state, int scale) {
+        frame.clear(frame.map(204, 200, 153));
+        drawBoard(frame, state.body, state.food, state.bonusActive ? &state.bonusFood : nullptr);
+        renderScore(frame, text, state.score, label);
+        if (scale == 1) return frame;
+        frame.upscaleTo(scaled, scale);
+        return scaled;
+    }
+};
+
+int main(int argc, char **argv) {
+    Options options = parseOptions(argc, argv);
+
+    Replay replay;
+    if (!replay.load(options.replay)) {
+        std::fprintf(stderr, "replay2video: cannot read replay %s\n", options.replay);
+        return 1;
+    }
+    const int width = replay.width * options.scale, height = replay.height * options.scale;
+    if (options.y4m && (width % 2 || height % 2)) {
+        std::fprintf(stderr, "replay2video: Y4M needs an even frame size, not %dx%d\n", width, height);
+        return 1;
+    }
+
+    FILE *y4m = nullptr;
+    if (options.y4m) {
+        y4m = std::strcmp(options.y4m, "-") == 0 ? stdout : std::fopen(options.y4m, "wb");
+        if (!y4m) {
+            std::fprintf(stderr, "replay2video: cannot write %s\n", options.y4m);
+            return 1;
+        }
+        std::vector<uint8_t> header;
+        y4mHeader(header, width, height, replay.fps);
+        std::fwrite(header.data(), 1, header.size(), y4m);
+    }
+
+    // Fallback fonts are opened here, one per worker, because opening and
+    // closing them is not thread-safe while drawing with separate fonts is.
+    TTF_Init();
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < options.jobs; ++i) {
+        workers.emplace_back(new Worker(replay, options.scale, options.font));
+        if (options.font && !workers.back()->text.openFallback())
+            std::fprintf(stderr, "replay2video: cannot open font %s\n", options.font);
+    }
+
+    // Keep roughly 512 MB of encoded frames in flight at most. A PNG frame is
+    // at worst its RGB rows at 9 bits a byte, fixed-Huffman literals' longest.
+    size_t frameBytes = y4m ? size_t(width) * height * 3 / 2 : size_t(height) * (size_t(width) * 3 + 1) * 9 / 8 + 1024;
+    ReorderBuffer buffer(std::max<size_t>(options.jobs * 2, (size_t(512) << 20) / frameBytes));
+    std::atomic<size_t> nextSegment{0};
+    std::atomic<bool> corrupt{false};
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (auto &worker : workers) {
+        threads.emplace_back([&, w = worker.get()] {
+            ReplayState state;
+            for (size_t s; (s = nextSegment++) < replay.segments.size();) {
+                const Replay::Segment &segment = replay.segments[s];
+                Replay::Reader reader(replay, segment);
+                for (size_t i = 0; i < segment.frames; ++i) {
+                    if (!reader.next(state)) {
+                        corrupt = true;
+                        buffer.fail();
+                        return;
+                    }
+                    const SoftFramebuffer &fb = w->draw(state, options.scale);
+                    std::vector<uint8_t> bytes;
+                    if (y4m) encodeY4mFrame(bytes, fb.row(0), width, height, fb.pitch());
+                    else encodePng(bytes, fb.row(0), width, height, fb.pitch());
+                    if (!buffer.put(segment.firstFrame + i, std::move(bytes))) return; // the run failed
+                }
+            }
+        });
+    }
+
+    bool ok = true;
+    std::vector<uint8_t> bytes;
+    char path[4096];
+    for (size_t frame = 0; frame < replay.frames && ok; ++frame) {
+        if (!buffer.take(bytes)) {
+            ok = false;
+            break;
+        }
+        if (y4m) {
+            ok = std::fwrite(bytes.data(), 1, bytes.size(), y4m) == bytes.size();
+        } else {
+            std::snprintf(path, sizeof path, "%s/frame_%06zu.png", options.pngDir, frame);
+            ok = writeFile(path, bytes);
+        }
+        if (!ok) {
+            std::fprintf(stderr, "replay2video: write failed at frame %zu\n", frame);
+            buffer.fail();
+        }
+    }
+    for (auto &t : threads) t.join();
+    if (y4m && y4m != stdout) std::fclose(y4m);
+    if (corrupt) std::fprintf(stderr, "replay2video: replay is corrupt\n");
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double realTime = replay.fps ? double(replay.frames) / replay.fps : 0.0;
+    std::fprintf(stderr, "replay2video: %zu frames (%zu segments) at %dx%d on %d threads in %.2f s: %.1f fps, %.1fx real time\n",
+                 replay.frames, replay.segments.size(), width, height, options.jobs, seconds, replay.frames / seconds,
+                 realTime / seconds);
+
+    workers.clear();
+    TTF_Quit();
+    return ok && !corrupt ? 0 : 1;
+}
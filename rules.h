@@ -0,0 +1,468 @@
+// One snake engine for the rules of test.cpp, a.cpp and b.cpp.
+//
+// The three games differ in four rules: what the edge of the board does,
+// what running into an obstacle does, when food appears, and what it is
+// worth. SnakeEngine takes a policy type for each, so every variant is a
+// type alias whose tick has no branches on which rules are in play. The
+// Runtime* policies read the rule from a RuleConfig instead, for servers
+// that take their rules from a file; ConfigurableGame is the same engine
+// built from those.
+//
+// A fifth, optional policy looks for a snake that has sealed itself in, for
+// bulk simulation where such games would otherwise run on to the collision.
+//
+// Coordinates are in tiles.
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "level.h"
+
+namespace rules {
+
+enum Outcome { MOVED, ATE, PAUSED, DIED, TRAPPED };
+
+// Walls on a cols x rows grid, and where the snake starts.
+struct Board {
+    int cols, rows;
+    SDL_Point start;
+    std::vector<uint8_t> walls;
+
+    Board(int cols, int rows, SDL_Point start) : cols(cols), rows(rows), start(start), walls(size_t(cols) * rows) {}
+
+    // The walls of a level file, starting at its first spawn point or, with
+    // none, in the middle.
+    explicit Board(const Level &level) : Board(level.cols(), level.rows(), {level.cols() / 2, level.rows() / 2}) {
+        if (level.spawnCount() > 0) start = {level.spawn(0).x, level.spawn(0).y};
+        for (int y = 0; y < rows; ++y)
+            for (int x = 0; x < cols; ++x) walls[size_t(y) * cols + x] = level.wall(x, y);
+    }
+
+    // The same for a level still being built, such as a generated one.
+    explicit Board(const LevelData &level) : Board(level.cols, level.rows, {level.cols / 2, level.rows / 2}) {
+        if (!level.spawns.empty()) start = {level.spawns[0].x, level.spawns[0].y};
+        for (size_t i = 0; i < walls.size(); ++i) walls[i] = level.walls[i] != 0;
+    }
+
+    // Marks a w x h block of tiles, clipped to the board.
+    void addWall(int x, int y, int w, int h) {
+        for (int ty = std::max(y, 0); ty < std::min(y + h, rows); ++ty)
+            for (int tx = std::max(x, 0); tx < std::min(x + w, cols); ++tx) walls[size_t(ty) * cols + tx] = 1;
+    }
+
+    bool wall(SDL_Point p) const { return walls[size_t(p.y) * cols + p.x] != 0; }
+};
+
+// Boundary policies move a head that left the board back onto it, or
+// return false when leaving it is fatal. offset() is the shortest way from
+// one coordinate to another along an axis, for anything that steers.
+struct EdgeKills {
+    bool apply(SDL_Point &p, int cols, int rows) const { return unsigned(p.x) < unsigned(cols) && unsigned(p.y) < unsigned(rows); }
+    int offset(int from, int to, int) const { return to - from; }
+};
+
+// Leaving one edge comes back at the other, as in test.cpp --wrap. A move is
+// one tile, so a compare each way brings the head back, and the compares
+// become arithmetic rather than branches.
+struct EdgeWraps {
+    bool apply(SDL_Point &p, int cols, int rows) const {
+        p.x += ((p.x < 0) - (p.x >= cols)) * cols;
+        p.y += ((p.y < 0) - (p.y >= rows)) * rows;
+        return true;
+    }
+    int offset(int from, int to, int size) const {
+        int d = to - from;
+        d -= (2 * d > size) * size;
+        d += (2 * d < -size) * size;
+        return d;
+    }
+};
+
+// The same with masks, for boards whose sides are both powers of two.
+struct PowerOfTwoWrap : EdgeWraps {
+    bool apply(SDL_Point &p, int cols, int rows) const {
+        p.x &= cols - 1;
+        p.y &= rows - 1;
+        return true;
+    }
+};
+
+// Obstacle policies say what moving into a wall tile does.
+struct ObstacleKills {
+    Outcome hit() const { return DIED; }
+};
+
+// a.cpp's pauseGame(): the snake stays put until the player either ends the
+// game or resumes, which costs the scoring policy's penalty.
+struct ObstaclePauses {
+    Outcome hit() const { return PAUSED; }
+};
+
+// Food policies decide when bonus food appears with the ordinary food, and
+// for how many ticks it stays.
+struct OneFood {
+    bool bonusAt(int) const { return false; }
+    int bonusTicks() const { return 0; }
+};
+
+// b.cpp: a bonus whenever food is placed at a score that is a multiple of
+// Every, gone after Ticks ticks.
+template <int Every, int Ticks>
+struct BonusFood {
+    bool bonusAt(int score) const { return score % Every == 0; }
+    int bonusTicks() const { return Ticks; }
+};
+
+// Scoring: points for food and bonus food, and the penalty for resuming
+// after an obstacle pause.
+template <int Food, int Bonus = 0, int Penalty = 0>
+struct Points {
+    int food() const { return Food; }
+    int bonus() const { return Bonus; }
+    int penalty() const { return Penalty; }
+};
+
+// Trap checks. When the head leaves a chokepoint, one whose tile split the
+// open tiles around it, the engine counts what the head can still reach. If
+// that runs out before any of the body next to it has moved away, the snake
+// is certain to die, whatever it does. TrapsEnd ends the game there with
+// TRAPPED; TrapsNoted only records the tick, to see what ending would save.
+struct NoTrapCheck {
+    bool enabled() const { return false; }
+    bool ends() const { return false; }
+};
+
+struct TrapsEnd {
+    bool enabled() const { return true; }
+    bool ends() const { return true; }
+};
+
+struct TrapsNoted {
+    bool enabled() const { return true; }
+    bool ends() const { return false; }
+};
+
+template <class Boundary, class Obstacles, class Food, class Scoring, class Traps = NoTrapCheck>
+class SnakeEngine {
+public:
+    SnakeEngine(const Board &board, unsigned seed, Boundary boundary = {}, Obstacles obstacles = {}, Food food = {},
+                Scoring scoring = {}, Traps traps = {})
+        : board(board), boundary(boundary), obstacles(obstacles), foodRule(food), scoring(scoring), traps(traps),
+          body(size_t(board.cols) * board.rows), occupied(body.size()), rng(seed) {
+        if (traps.enabled()) {
+            entered.resize(body.size());
+            seen.resize(body.size());
+            queue.resize(body.size());
+        }
+        reset();
+    }
+
+    // A one-tile snake on the start tile, heading right, with score 0.
+    void reset() {
+        for (size_t i = 0; i < length; ++i) occupied[index(segment(i))] = 0;
+        first = 0;
+        length = 1;
+        body[0] = board.start;
+        occupied[index(board.start)] = 1;
+        dx = 1;
+        dy = 0;
+        growth = 0;
+        points = 0;
+        tick = 0;
+        dead = false;
+        bonusActive = false;
+        moves = 0;
+        checkTrap = false;
+        trappedTick = -1;
+        if (traps.enabled()) entered[index(board.start)] = 0;
+        spawnFood();
+    }
+
+    // Turns unless that would reverse onto the neck.
+    void steer(int x, int y) {
+        if (length > 1 && x == -dx && y == -dy) return;
+        dx = x;
+        dy = y;
+    }
+
+    Outcome step() {
+        if (dead) return DIED;
+        tick++;
+        if (bonusActive && tick >= bonusExpires) bonusActive = false;
+
+        SDL_Point next = {head().x + dx, head().y + dy};
+        if (!boundary.apply(next, board.cols, board.rows)) return die();
+        if (board.wall(next)) {
+            Outcome o = obstacles.hit();
+            dead = o == DIED;
+            return o;
+        }
+
+        // The tail moves out of the way first, so following it is allowed.
+        if (growth > 0) {
+            growth--;
+        } else {
+            occupied[index(segment(length - 1))] = 0;
+            length--;
+        }
+        if (occupied[index(next)]) return die();
+        first = first ? first - 1 : body.size() - 1;
+        body[first] = next;
+        occupied[index(next)] = 1;
+        length++;
+        moves++;
+
+        Outcome result = MOVED;
+        if (same(next, foodAt)) {
+            points += scoring.food();
+            growth++;
+            spawnFood();
+            result = ATE;
+        }
+        if (bonusActive && same(next, bonusAt)) {
+            points += scoring.bonus();
+            growth++;
+            bonusActive = false;
+            result = ATE;
+        }
+        if (traps.enabled()) {
+            entered[index(next)] = moves;
+            if (checkTrap && trappedTick < 0 && sealedIn()) {
+                trappedTick = tick;
+                if (traps.ends()) {
+                    dead = true;
+                    return TRAPPED;
+                }
+            }
+            checkTrap = chokepoint(next);
+        }
+        return result;
+    }
+
+    // Continues after PAUSED, paying the penalty.
+    void resume() { points = std::max(0, points - scoring.penalty()); }
+
+    // Whether moving (x, y) from the head leads onto a free tile, ignoring
+    // the tail that would move out of the way.
+    bool canEnter(int x, int y) const {
+        SDL_Point next = {head().x + x, head().y + y};
+        return boundary.apply(next, board.cols, board.rows) && !board.wall(next) && !occupied[index(next)];
+    }
+
+    // The shortest move from the head to p on each axis, across the edges
+    // when the board wraps.
+    SDL_Point offsetTo(SDL_Point p) const {
+        return {boundary.offset(head().x, p.x, board.cols), boundary.offset(head().y, p.y, board.rows)};
+    }
+
+    SDL_Point head() const { return body[first]; }
+    SDL_Point segment(size_t i) const { return body[(first + i) % body.size()]; } // 0 = head
+    size_t size() const { return length; }
+    SDL_Point food() const { return foodAt; }
+    const SDL_Point *bonus() const { return bonusActive ? &bonusAt : nullptr; }
+    int score() const { return points; }
+    bool alive() const { return !dead; }
+    long long ticks() const { return tick; }
+    long long trappedAt() const { return trappedTick; } // -1 until a trap check finds the snake sealed in
+
+private:
+    size_t index(SDL_Point p) const { return size_t(p.y) * board.cols + p.x; }
+    static bool same(SDL_Point a, SDL_Point b) { return a.x == b.x && a.y == b.y; }
+
+    Outcome die() {
+        dead = true;
+        return DIED;
+    }
+
+    void spawnFood() {
+        foodAt = freeTile();
+        if (foodRule.bonusAt(points)) {
+            bonusActive = true;
+            bonusExpires = tick + foodRule.bonusTicks();
+            bonusAt = freeTile();
+        }
+    }
+
+    // A few random probes, then a scan from a random tile, so a crowded
+    // board still finds a place without allocating.
+    SDL_Point freeTile() {
+        std::uniform_int_distribution<size_t> pick(0, occupied.size() - 1);
+        size_t i = pick(rng);
+        for (int attempt = 0; attempt < 16 && (occupied[i] || board.walls[i]); ++attempt) i = pick(rng);
+        for (size_t n = 0; n < occupied.size() && (occupied[i] || board.walls[i]); ++n) i = (i + 1) % occupied.size();
+        return {int(i % board.cols), int(i / board.cols)};
+    }
+
+    // Whether blocking p could have cut the open tiles around it in two: its
+    // open sides do not all join up through the open corners between them.
+    // This runs every tick, so away from the edges the eight neighbours are
+    // read at fixed steps from p's index, and the answer for their pattern
+    // comes from a table.
+    bool chokepoint(SDL_Point p) const {
+        static const int RING[8][2] = {{0, -1}, {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}};
+        static constexpr std::array<bool, 256> SPLITS = splitPatterns();
+        unsigned open = 0;
+        if (p.x > 0 && p.y > 0 && p.x < board.cols - 1 && p.y < board.rows - 1) {
+            const ptrdiff_t c = board.cols;
+            const ptrdiff_t steps[8] = {-c, 1 - c, 1, c + 1, c, c - 1, -1, -c - 1};
+            const uint8_t *walls = board.walls.data() + index(p), *body = occupied.data() + index(p);
+            for (int k = 0; k < 8; ++k) open |= unsigned((walls[steps[k]] | body[steps[k]]) == 0) << k;
+        } else {
+            for (int k = 0; k < 8; ++k) {
+                SDL_Point q = {p.x + RING[k][0], p.y + RING[k][1]};
+                open |= unsigned(boundary.apply(q, board.cols, board.rows) && !board.wall(q) && !occupied[index(q)]) << k;
+            }
+        }
+        return SPLITS[open];
+    }
+
+    // For each pattern of open neighbours (bit k for RING[k], sides on even
+    // k), whether the open sides fall into two or more groups.
+    static constexpr std::array<bool, 256> splitPatterns() {
+        std::array<bool, 256> splits = {};
+        for (unsigned open = 0; open < 256; ++open) {
+            int sides = 0, joins = 0;
+            for (int k = 0; k < 8; k += 2) {
+                bool side = open >> k & 1, corner = open >> (k + 1) & 1, nextSide = open >> ((k + 2) % 8) & 1;
+                sides += side;
+                joins += side && corner && nextSide;
+            }
+            splits[open] = (sides == 4 && joins == 4 ? 1 : sides - joins) >= 2;
+        }
+        return splits;
+    }
+
+    // Counts the open tiles the head can reach, stopping once there are
+    // enough to outlast the body. The segment i tiles from the head is
+    // gone after length - i + growth moves, so a snake with `room` moves
+    // left escapes if one next to the head's region goes by move room + 1.
+    // Food eaten on the way only delays the tail, so ignoring it never
+    // calls a snake trapped that is not.
+    bool sealedIn() {
+        if (++stamp == 0) {
+            std::fill(seen.begin(), seen.end(), 0);
+            stamp = 1;
+        }
+        const long long need = (long long)length + growth - 1; // the head itself always frees by then
+        long long room = 0, freeing = need + 1;                // soonest move a neighbouring segment is gone
+        size_t front = 0, back = 0;
+        queue[back++] = uint32_t(index(head()));
+        seen[queue[0]] = stamp;
+        static const int DIRS[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+        while (front < back) {
+            uint32_t i = queue[front++];
+            SDL_Point p = {int(i % board.cols), int(i / board.cols)};
+            for (const auto &d : DIRS) {
+                SDL_Point q = {p.x + d[0], p.y + d[1]};
+                if (!boundary.apply(q, board.cols, board.rows) || board.wall(q)) continue;
+                size_t n = index(q);
+                if (seen[n] == stamp) continue;
+                seen[n] = stamp;
+                if (occupied[n]) {
+                    long long segment = moves - entered[n];
+                    freeing = std::min(freeing, (long long)length - segment + growth);
+                    continue;
+                }
+                if (++room >= need) return false;
+                queue[back++] = uint32_t(n);
+            }
+        }
+        return freeing > room + 1;
+    }
+
+    const Board &board;
+    Boundary boundary;
+    Obstacles obstacles;
+    Food foodRule;
+    Scoring scoring;
+    Traps traps;
+
+    std::vector<SDL_Point> body;   // ring, head at first
+    std::vector<uint8_t> occupied; // per tile
+    size_t first = 0, length = 0;
+    int dx = 1, dy = 0;
+    int growth = 0, points = 0;
+    long long tick = 0, bonusExpires = 0;
+    bool dead = false, bonusActive = false;
+    SDL_Point foodAt = {0, 0}, bonusAt = {0, 0};
+    std::mt19937 rng;
+
+    // Trap checks only.
+    std::vector<long long> entered; // per tile, the move that put the body there
+    std::vector<uint32_t> seen;     // per tile, the stamp of the last check that reached it
+    std::vector<uint32_t> queue;
+    uint32_t stamp = 0;
+    long long moves = 0, trappedTick = -1;
+    bool checkTrap = false;
+};
+
+// The games as they are, on boards of their own. test.cpp plays the first
+// two; a.cpp and b.cpp still keep their own rules.
+using ClassicGame = SnakeEngine<EdgeKills, ObstacleKills, OneFood, Points<1>>;              // test.cpp
+using WrapGame = SnakeEngine<EdgeWraps, ObstacleKills, OneFood, Points<1>>;                 // test.cpp --wrap
+using MaskedWrapGame = SnakeEngine<PowerOfTwoWrap, ObstacleKills, OneFood, Points<1>>;      // wrap, power-of-two sides
+using ObstacleGame = SnakeEngine<EdgeKills, ObstaclePauses, OneFood, Points<1, 0, 10>>;     // a.cpp
+using BonusGame = SnakeEngine<EdgeKills, ObstacleKills, BonusFood<5, 70>, Points<1, 10>>;  // b.cpp: 7 s at 10 ticks/s
+
+// Rules chosen when the program runs.
+enum class BoundaryRule { KILL, WRAP };
+enum class ObstacleRule { KILL, PAUSE };
+
+enum class TrapRule { OFF, END, NOTE };
+
+struct RuleConfig {
+    BoundaryRule boundary = BoundaryRule::KILL;
+    ObstacleRule obstacle = ObstacleRule::KILL;
+    TrapRule trap = TrapRule::OFF;
+    int bonusEvery = 0; // 0 for no bonus food
+    int bonusTicks = 0;
+    int foodPoints = 1, bonusPoints = 0, penalty = 0;
+};
+
+struct RuntimeBoundary {
+    BoundaryRule rule;
+    bool apply(SDL_Point &p, int cols, int rows) const {
+        return rule == BoundaryRule::WRAP ? EdgeWraps().apply(p, cols, rows) : EdgeKills().apply(p, cols, rows);
+    }
+    int offset(int from, int to, int size) const {
+        return rule == BoundaryRule::WRAP ? EdgeWraps().offset(from, to, size) : EdgeKills().offset(from, to, size);
+    }
+};
+
+struct RuntimeObstacles {
+    ObstacleRule rule;
+    Outcome hit() const { return rule == ObstacleRule::PAUSE ? PAUSED : DIED; }
+};
+
+struct RuntimeFood {
+    int every, ticks;
+    bool bonusAt(int score) const { return every > 0 && score % every == 0; }
+    int bonusTicks() const { return ticks; }
+};
+
+struct RuntimeScoring {
+    int foodPoints, bonusPoints, penaltyPoints;
+    int food() const { return foodPoints; }
+    int bonus() const { return bonusPoints; }
+    int penalty() const { return penaltyPoints; }
+};
+
+struct RuntimeTraps {
+    TrapRule rule;
+    bool enabled() const { return rule != TrapRule::OFF; }
+    bool ends() const { return rule == TrapRule::END; }
+};
+
+using ConfigurableGame = SnakeEngine<RuntimeBoundary, RuntimeObstacles, RuntimeFood, RuntimeScoring, RuntimeTraps>;
+
+inline ConfigurableGame makeGame(const Board &board, const RuleConfig &config, unsigned seed) {
+    return ConfigurableGame(board, seed, {config.boundary}, {config.obstacle}, {config.bonusEvery, config.bonusTicks},
+                            {config.foodPoints, config.bonusPoints, config.penalty}, {config.trap});
+}
+
+} // namespace rules
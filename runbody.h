@@ -0,0 +1,112 @@
+// Run-length encoded snake body for very long snakes.
+//
+// Instead of one SDL_Rect per segment, the body is stored as straight runs:
+// the cell at the head end of the run, the direction the snake was moving
+// along it, and how many cells it covers. Moving the head either extends the
+// front run or starts a new one, and moving the tail shortens the back run,
+// so both are O(1) and memory grows with the number of turns, not the length.
+//
+// Coordinates are in tiles.
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <memory_resource>
+#include <vector>
+
+struct BodyRun {
+    int x, y;   // head end of the run
+    int dx, dy; // direction of travel along the run (one of them is 0)
+    int length; // cells, at least 1
+};
+
+class RunBody {
+public:
+    RunBody() : runs(16), first(0), count(0), cells(0) {}
+
+    // Starts a body of a single cell.
+    void reset(int x, int y) {
+        first = 0;
+        count = 1;
+        runs[0] = {x, y, 0, 0, 1};
+        cells = 1;
+    }
+
+    size_t size() const { return cells; }
+    size_t runCount() const { return count; }
+    const BodyRun& run(size_t i) const { return runs[(first + i) & (runs.size() - 1)]; } // 0 = head
+
+    SDL_Point head() const { return {run(0).x, run(0).y}; }
+    SDL_Point tail() const {
+        const BodyRun& r = run(count - 1);
+        return {r.x - r.dx * (r.length - 1), r.y - r.dy * (r.length - 1)};
+    }
+
+    // Moves the head one cell in direction (dx, dy). The front run grows when
+    // the direction is unchanged; otherwise the turn starts a new run.
+    void advanceHead(int dx, int dy) {
+        BodyRun& front = runs[first];
+        int x = front.x + dx, y = front.y + dy;
+        if (front.length == 1 && front.dx == 0 && front.dy == 0) {
+            // A lone cell has no direction yet; it becomes the tail of this run.
+            front = {x, y, dx, dy, 2};
+        } else if (front.dx == dx && front.dy == dy) {
+            front.x = x;
+            front.y = y;
+            front.length++;
+        } else {
+            if (count == runs.size()) grow();
+            first = (first - 1) & (runs.size() - 1);
+            runs[first] = {x, y, dx, dy, 1};
+            count++;
+        }
+        cells++;
+    }
+
+    // Drops the tail cell.
+    void retractTail() {
+        if (cells <= 1) return;
+        BodyRun& back = runs[(first + count - 1) & (runs.size() - 1)];
+        if (--back.length == 0) count--;
+        cells--;
+    }
+
+    // O(number of runs) membership test.
+    bool contains(int x, int y) const {
+        for (size_t i = 0; i < count; ++i) {
+            const BodyRun& r = run(i);
+            // The cell is on the run if it lies k steps back from the head end.
+            int bx = r.x - x, by = r.y - y;
+            int k = r.dx ? bx * r.dx : by * r.dy;
+            if (bx == k * r.dx && by == k * r.dy && k >= 0 && k < r.length) return true;
+        }
+        return false;
+    }
+
+    // One rectangle per run in pixels, so drawing costs one fill per turn.
+    void appendRects(std::pmr::vector<SDL_Rect>& out, int tileSize) const {
+        for (size_t i = 0; i < count; ++i) {
+            const BodyRun& r = run(i);
+            int tx = r.x - r.dx * (r.length - 1), ty = r.y - r.dy * (r.length - 1);
+            int x0 = r.x < tx ? r.x : tx, y0 = r.y < ty ? r.y : ty;
+            int w = r.dx ? r.length : 1, h = r.dx ? 1 : r.length;
+            out.push_back({x0 * tileSize, y0 * tileSize, w * tileSize, h * tileSize});
+        }
+    }
+
+    // Bytes held by the run storage.
+    size_t memoryBytes() const { return runs.capacity() * sizeof(BodyRun); }
+
+private:
+    // Doubles the ring, unrolling it so the head run is at index 0.
+    void grow() {
+        std::vector<BodyRun> bigger(runs.size() * 2);
+        for (size_t i = 0; i < count; ++i) bigger[i] = run(i);
+        runs.swap(bigger);
+        first = 0;
+    }
+
+    std::vector<BodyRun> runs; // ring buffer, size is a power of two
+    size_t first;              // index of the head run
+    size_t count;
+    size_t cells;
+};
@@ -0,0 +1,126 @@
+// Screenshots written by a background thread.
+//
+// capture() copies the current frame with SDL_RenderReadPixels into one of a
+// few buffers and queues it. The worker thread allocates the buffers when it
+// starts, encodes each queued frame (PNG or BMP, imageio.h) and writes the
+// file, so the frame that takes the screenshot only pays for the read-back.
+// When every buffer is still waiting to be written the screenshot is dropped
+// rather than stalling the game.
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "imageio.h"
+
+class ScreenshotWriter {
+public:
+    enum Format { PNG, BMP };
+
+    ScreenshotWriter(int width, int height, int buffers = 2)
+        : width(width), height(height), shots(buffers), thread([this] { run(); }) {}
+
+    ~ScreenshotWriter() { stop(); }
+
+    ScreenshotWriter(const ScreenshotWriter&) = delete;
+    ScreenshotWriter& operator=(const ScreenshotWriter&) = delete;
+
+    // Reads the frame rendered so far; call it before SDL_RenderPresent,
+    // after which the back buffer is undefined. Returns false when the
+    // screenshot was dropped.
+    bool capture(SDL_Renderer *renderer, Format format, std::string path) {
+        Uint64 start = SDL_GetPerformanceCounter();
+        size_t index;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (idle.empty() || stopping) return false;
+            index = idle.back();
+            idle.pop_back();
+        }
+
+        Shot &shot = shots[index];
+        SDL_Rect area = {0, 0, width, height};
+        bool ok = SDL_RenderReadPixels(renderer, &area, SDL_PIXELFORMAT_RGBA32, shot.pixels.data(), width * 4) == 0;
+        shot.format = format;
+        shot.path = std::move(path);
+        shot.captureMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (ok) pending.push_back(index);
+            else idle.push_back(index);
+        }
+        if (!ok) {
+            std::fprintf(stderr, "Cannot read the frame for a screenshot: %s\n", SDL_GetError());
+            return false;
+        }
+        wake.notify_one();
+        return true;
+    }
+
+    // Writes the screenshots still queued and ends the thread.
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        if (thread.joinable()) thread.join();
+    }
+
+private:
+    struct Shot {
+        std::vector<uint8_t> pixels; // RGBA32
+        Format format = PNG;
+        std::string path;
+        double captureMs = 0; // what capture() added to its frame
+    };
+
+    void run() {
+        // Off the thread that starts the game, which has a first frame to show.
+        for (size_t i = 0; i < shots.size(); ++i) {
+            shots[i].pixels.resize(size_t(width) * height * 4);
+            std::lock_guard<std::mutex> lock(mutex);
+            idle.push_back(i);
+        }
+
+        std::vector<uint8_t> file; // reused between screenshots
+        for (;;) {
+            size_t index;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return !pending.empty() || stopping; });
+                if (pending.empty()) return;
+                index = pending.front();
+                pending.pop_front();
+            }
+
+            Shot &shot = shots[index];
+            Uint64 start = SDL_GetPerformanceCounter();
+            if (shot.format == PNG) encodePng(file, shot.pixels.data(), width, height, width * 4);
+            else encodeBmp(file, shot.pixels.data(), width, height, width * 4);
+            double encodeMs = (SDL_GetPerformanceCounter() - start) * 1000.0 / SDL_GetPerformanceFrequency();
+            if (writeFile(shot.path.c_str(), file))
+                std::printf("Saved %s: %.2f ms added to the frame, %.1f ms to encode off-thread\n", shot.path.c_str(),
+                            shot.captureMs, encodeMs);
+            else
+                std::fprintf(stderr, "Cannot write screenshot %s\n", shot.path.c_str());
+
+            std::lock_guard<std::mutex> lock(mutex);
+            idle.push_back(index);
+        }
+    }
+
+    int width, height;
+    std::vector<Shot> shots;
+    std::vector<size_t> idle;   // free buffers
+    std::deque<size_t> pending; // captured, waiting for the thread
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread thread; // last, so it starts after everything it uses
+};
@@ -0,0 +1,261 @@
+// Software rasterizer for frames made without a GPU: replays, CI screenshots
+// and the --software mode of b.cpp.
+//
+// A SoftFramebuffer holds RGBA32 pixels or 8-bit palette indices. Everything
+// drawn is a solid rectangle or a text mask, so drawing comes down to
+// horizontal span fills, which use AVX2 or SSE2 stores when the CPU has them.
+// upscaleTo() enlarges a frame by a whole factor with nearest-neighbour
+// sampling, e.g. 1080x720 x3 for a 4K video, expanding palette indices to
+// RGBA on the way.
+//
+// RGBA32 pixels are bytes R, G, B, A in memory (SDL_PIXELFORMAT_RGBA32).
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SOFTRASTER_X86 1
+#endif
+
+enum SimdLevel { SIMD_SCALAR, SIMD_SSE2, SIMD_AVX2 };
+
+namespace softraster {
+
+// Each fill writes `bytes` bytes of the repeating 4-byte pattern starting at
+// p. p must be 4-byte aligned unless all four pattern bytes are equal.
+inline void fillBytes(uint8_t *p, size_t bytes, uint32_t pattern) {
+    uint8_t b[4];
+    std::memcpy(b, &pattern, 4);
+    for (size_t i = 0; i < bytes; ++i) p[i] = b[reinterpret_cast<uintptr_t>(p + i) & 3];
+}
+
+// Portable path: whole 32-bit words between byte-wise ends.
+inline void fillScalar(uint8_t *p, size_t bytes, uint32_t pattern) {
+    size_t head = (4 - (reinterpret_cast<uintptr_t>(p) & 3)) & 3;
+    if (head >= bytes) return fillBytes(p, bytes, pattern);
+    fillBytes(p, head, pattern);
+    p += head;
+    bytes -= head;
+    for (; bytes >= 4; bytes -= 4, p += 4) std::memcpy(p, &pattern, 4);
+    fillBytes(p, bytes, pattern);
+}
+
+#ifdef SOFTRASTER_X86
+__attribute__((target("sse2"))) inline void fillSse2(uint8_t *p, size_t bytes, uint32_t pattern) {
+    size_t head = (16 - (reinterpret_cast<uintptr_t>(p) & 15)) & 15;
+    if (head >= bytes) return fillBytes(p, bytes, pattern);
+    fillBytes(p, head, pattern);
+    p += head;
+    bytes -= head;
+
+    const __m128i v = _mm_set1_epi32(static_cast<int>(pattern));
+    for (; bytes >= 64; bytes -= 64, p += 64) {
+        _mm_store_si128(reinterpret_cast<__m128i *>(p), v);
+        _mm_store_si128(reinterpret_cast<__m128i *>(p + 16), v);
+        _mm_store_si128(reinterpret_cast<__m128i *>(p + 32), v);
+        _mm_store_si128(reinterpret_cast<__m128i *>(p + 48), v);
+    }
+    for (; bytes >= 16; bytes -= 16, p += 16) _mm_store_si128(reinterpret_cast<__m128i *>(p), v);
+    fillBytes(p, bytes, pattern);
+}
+
+__attribute__((target("avx2"))) inline void fillAvx2(uint8_t *p, size_t bytes, uint32_t pattern) {
+    size_t head = (32 - (reinterpret_cast<uintptr_t>(p) & 31)) & 31;
+    if (head >= bytes) return fillBytes(p, bytes, pattern);
+    fillBytes(p, head, pattern);
+    p += head;
+    bytes -= head;
+
+    const __m256i v = _mm256_set1_epi32(static_cast<int>(pattern));
+    for (; bytes >= 128; bytes -= 128, p += 128) {
+        _mm256_store_si256(reinterpret_cast<__m256i *>(p), v);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(p + 32), v);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(p + 64), v);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(p + 96), v);
+    }
+    for (; bytes >= 32; bytes -= 32, p += 32) _mm256_store_si256(reinterpret_cast<__m256i *>(p), v);
+    fillBytes(p, bytes, pattern);
+}
+#endif
+
+using FillFn = void (*)(uint8_t *, size_t, uint32_t);
+
+inline SimdLevel bestSimd() {
+#ifdef SOFTRASTER_X86
+    if (SDL_HasAVX2()) return SIMD_AVX2;
+    if (SDL_HasSSE2()) return SIMD_SSE2;
+#endif
+    return SIMD_SCALAR;
+}
+
+inline FillFn fillFor(SimdLevel level) {
+#ifdef SOFTRASTER_X86
+    if (level == SIMD_AVX2) return fillAvx2;
+    if (level == SIMD_SSE2) return fillSse2;
+#endif
+    return fillScalar;
+}
+
+struct Dispatch {
+    SimdLevel level = bestSimd();
+    FillFn fill = fillFor(level);
+};
+
+inline Dispatch &dispatch() {
+    static Dispatch d;
+    return d;
+}
+
+} // namespace softraster
+
+inline SimdLevel simdLevel() { return softraster::dispatch().level; }
+
+// Lowers the SIMD level, e.g. to compare paths in a benchmark. Levels the
+// CPU does not have are ignored.
+inline void useSimd(SimdLevel level) {
+    if (level > softraster::bestSimd()) level = softraster::bestSimd();
+    softraster::dispatch().level = level;
+    softraster::dispatch().fill = softraster::fillFor(level);
+}
+
+class SoftFramebuffer {
+public:
+    enum Format { RGBA32, INDEXED8 };
+
+    SoftFramebuffer(int width, int height, Format format)
+        : w(width), h(height), fmt(format), bpp(format == RGBA32 ? 4 : 1), pixels(size_t(width) * height * bpp) {}
+
+    int width() const { return w; }
+    int height() const { return h; }
+    Format format() const { return fmt; }
+    int pitch() const { return w * bpp; }
+    const void *data() const { return pixels.data(); }
+    const uint8_t *row(int y) const { return pixels.data() + size_t(y) * pitch(); }
+
+    // The palette of an INDEXED8 buffer as RGBA32 pixels.
+    const std::vector<uint32_t> &palette() const { return colors; }
+
+    // The value to draw the colour with: an RGBA32 pixel, or a palette index,
+    // adding the colour to the palette if it is new. A full palette (256
+    // colours) answers with the nearest entry.
+    uint32_t map(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) {
+        const uint8_t bytes[4] = {r, g, b, a};
+        uint32_t rgba;
+        std::memcpy(&rgba, bytes, 4);
+        if (fmt == RGBA32) return rgba;
+
+        for (size_t i = 0; i < colors.size(); ++i)
+            if (colors[i] == rgba) return static_cast<uint32_t>(i);
+        if (colors.size() < 256) {
+            colors.push_back(rgba);
+            return static_cast<uint32_t>(colors.size() - 1);
+        }
+        uint32_t best = 0;
+        int bestDistance = 1 << 30;
+        for (size_t i = 0; i < colors.size(); ++i) {
+            uint8_t c[4];
+            std::memcpy(c, &colors[i], 4);
+            int d = (c[0] - r) * (c[0] - r) + (c[1] - g) * (c[1] - g) + (c[2] - b) * (c[2] - b);
+            if (d < bestDistance) {
+                bestDistance = d;
+                best = static_cast<uint32_t>(i);
+            }
+        }
+        return best;
+    }
+
+    void clear(uint32_t value) { fillRect({0, 0, w, h}, value); }
+
+    // Clipped to the framebuffer.
+    void fillRect(SDL_Rect r, uint32_t value) {
+        int x0 = r.x < 0 ? 0 : r.x, y0 = r.y < 0 ? 0 : r.y;
+        int x1 = r.x + r.w > w ? w : r.x + r.w, y1 = r.y + r.h > h ? h : r.y + r.h;
+        if (x0 >= x1 || y0 >= y1) return;
+        if (x0 == 0 && x1 == w) { // whole rows are one contiguous span
+            span(rowPtr(y0), size_t(y1 - y0) * w, value);
+            return;
+        }
+        for (int y = y0; y < y1; ++y) span(rowPtr(y) + size_t(x0) * bpp, x1 - x0, value);
+    }
+
+    // Stretches an 8-bit surface over dst and draws its non-zero pixels, which
+    // is how TTF_RenderText_Solid text is drawn: index 0 is the background.
+    void drawMask(const SDL_Surface *mask, SDL_Rect dst, uint32_t value) {
+        if (!mask || mask->format->BytesPerPixel != 1 || dst.w <= 0 || dst.h <= 0) return;
+        int x0 = dst.x < 0 ? 0 : dst.x, y0 = dst.y < 0 ? 0 : dst.y;
+        int x1 = dst.x + dst.w > w ? w : dst.x + dst.w, y1 = dst.y + dst.h > h ? h : dst.y + dst.h;
+        for (int y = y0; y < y1; ++y) {
+            const uint8_t *src = static_cast<const uint8_t *>(mask->pixels) + (y - dst.y) * mask->h / dst.h * mask->pitch;
+            for (int x = x0; x < x1;) {
+                if (!src[(x - dst.x) * mask->w / dst.w]) {
+                    ++x;
+                    continue;
+                }
+                int end = x + 1;
+                while (end < x1 && src[(end - dst.x) * mask->w / dst.w]) ++end;
+                span(rowPtr(y) + size_t(x) * bpp, end - x, value);
+                x = end;
+            }
+        }
+    }
+
+    // Draws this frame into dst, an RGBA32 buffer or one of the same format,
+    // `factor` times larger with its top-left corner at (ox, oy). Each run of
+    // equal source pixels becomes a single span fill, and the first row of
+    // every block is copied to the rest.
+    void upscaleTo(SoftFramebuffer &dst, int factor, int ox = 0, int oy = 0) const {
+        bool expand = fmt == INDEXED8 && dst.fmt == RGBA32;
+        if (!expand && dst.fmt != fmt) return;
+        int cols = (dst.w - ox) / factor < w ? (dst.w - ox) / factor : w;
+        int rows = (dst.h - oy) / factor < h ? (dst.h - oy) / factor : h;
+        if (cols <= 0 || rows <= 0) return;
+
+        for (int y = 0; y < rows; ++y) {
+            uint8_t *out = dst.rowPtr(oy + y * factor) + size_t(ox) * dst.bpp;
+            for (int x = 0; x < cols;) {
+                uint32_t v = read(x, y);
+                int end = x + 1;
+                while (end < cols && read(end, y) == v) ++end;
+                if (expand) v = v < colors.size() ? colors[v] : 0;
+                dst.span(out + size_t(x) * factor * dst.bpp, size_t(end - x) * factor, v);
+                x = end;
+            }
+            for (int k = 1; k < factor; ++k)
+                std::memcpy(dst.rowPtr(oy + y * factor + k) + size_t(ox) * dst.bpp, out, size_t(cols) * factor * dst.bpp);
+        }
+    }
+
+    // RGBA32 value of one pixel, looking palette indices up.
+    uint32_t rgbaAt(int x, int y) const {
+        uint32_t v = read(x, y);
+        return fmt == RGBA32 ? v : (v < colors.size() ? colors[v] : 0);
+    }
+
+private:
+    uint8_t *rowPtr(int y) { return pixels.data() + size_t(y) * pitch(); }
+
+    uint32_t read(int x, int y) const {
+        const uint8_t *p = row(y) + size_t(x) * bpp;
+        if (bpp == 1) return *p;
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+
+    // `count` pixels of value from p.
+    void span(uint8_t *p, size_t count, uint32_t value) {
+        uint32_t pattern = bpp == 4 ? value : (value & 0xff) * 0x01010101u;
+        softraster::dispatch().fill(p, count * bpp, pattern);
+    }
+
+    int w, h;
+    Format fmt;
+    int bpp;
+    std::vector<uint8_t> pixels;
+    std::vector<uint32_t> colors;
+};
@@ -0,0 +1,60 @@
+// Where the time before the first frame goes. Each mark() ends a step that
+// started at the previous mark; steps run on other threads are added with
+// markBackground(). print() lists the steps so far, and steps finishing
+// after that are printed as they come in.
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+#include "procstats.h"
+
+class StartupTimeline {
+public:
+    explicit StartupTimeline(bool enabled) : enabled(enabled), start(SDL_GetPerformanceCounter()), last(start) {}
+
+    void mark(const char *step) {
+        Uint64 now = SDL_GetPerformanceCounter();
+        add(step, last, now, false);
+        last = now;
+    }
+
+    // A step another thread ran from `from` (a SDL_GetPerformanceCounter()
+    // value) until now.
+    void markBackground(const char *step, Uint64 from) { add(step, from, SDL_GetPerformanceCounter(), true); }
+
+    void print() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!enabled || printed) return;
+        for (const Step &s : steps) printStep(s);
+        std::printf("startup: %.1f MB resident\n", residentBytes() / 1048576.0);
+        printed = true;
+    }
+
+private:
+    struct Step {
+        const char *name;
+        double ms, endMs;
+        bool background;
+    };
+
+    void add(const char *name, Uint64 from, Uint64 to, bool background) {
+        if (!enabled) return;
+        const double toMs = 1000.0 / SDL_GetPerformanceFrequency();
+        Step s = {name, (to - from) * toMs, (to - start) * toMs, background};
+        std::lock_guard<std::mutex> lock(mutex);
+        steps.push_back(s);
+        if (printed) printStep(s);
+    }
+
+    static void printStep(const Step &s) {
+        std::printf("startup: %8.2f ms  %-24s done at %8.2f ms%s\n", s.ms, s.name, s.endMs, s.background ? " (background)" : "");
+    }
+
+    bool enabled;
+    Uint64 start, last;
+    std::mutex mutex;
+    std::vector<Step> steps;
+    bool printed = false;
+};
@@ -1,11 +1,10 @@
 
 #include <SDL2/SDL.h>
-#include <deque>
-#include <vector>
 #include <cstdlib>
 #include <ctime>
 #include <iostream>
 #include <SDL2/SDL_ttf.h>
+#include "rules.h"
 using namespace std;
 
 
@@ -13,11 +12,13 @@ const int WINDOW_WIDTH = 640;
 const int WINDOW_HEIGHT = 440;
 const int TILE_SIZE = 20;
 
-enum Direction { UP, DOWN, LEFT, RIGHT };
-
+// The rules are rules.h's: Game is rules::ClassicGame, or rules::WrapGame,
+// where the snake leaves one edge and comes back at the other instead of
+// dying. This file only reads the keys and draws the board.
+template <class Game>
 class SnakeGame {
 public:
-    SnakeGame() : direction(RIGHT), snakeSize(1), score(0) {
+    SnakeGame() : board(COLS, ROWS, {0, ROWS / 2}), game(board, static_cast<unsigned>(time(0))) {
         
         if (SDL_Init(SDL_INIT_VIDEO) < 0) {
             cerr << "Failed to initialize SDL: " << SDL_GetError() << std::endl;
@@ -27,14 +28,6 @@ public:
         
         window = SDL_CreateWindow("Snake Game", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, WINDOW_WIDTH, WINDOW_HEIGHT, SDL_WINDOW_SHOWN);
         renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
-
-        
-        snakeHead = {0, WINDOW_HEIGHT / 2, TILE_SIZE, TILE_SIZE};
-        snakeBody.push_back(snakeHead);
-
-        
-        srand(static_cast<unsigned>(time(0)));
-        generateApple();
     }
 
     ~SnakeGame() {
@@ -44,7 +37,6 @@ public:
     }
 
     void run() {
-        bool running = true;
         SDL_Event event;
 
         while (running) {
@@ -64,103 +56,39 @@ public:
             
             render();
 
-            // generateAppleWithTimer(4); // New apple every 5 seconds
-
             SDL_Delay(150); 
         }
     }
 
 private:
+    static const int COLS = WINDOW_WIDTH / TILE_SIZE;
+    static const int ROWS = WINDOW_HEIGHT / TILE_SIZE;
+
+    rules::Board board; // before game, which keeps a reference to it
+    Game game;
     SDL_Window* window;
     SDL_Renderer* renderer;
-    SDL_Rect snakeHead;
-    deque<SDL_Rect> snakeBody;
-    SDL_Rect apple;
-    Direction direction;
-    int snakeSize;
-    int score;
-
-    Uint32 lastAppleTime; 
-
-    int getRandomCoord() {
-        return (rand() % (WINDOW_WIDTH / TILE_SIZE)) * TILE_SIZE;
-    }
+    bool running = true;
 
     void handleDirection(SDL_Keycode key) {
         switch (key) {
-            case SDLK_UP:
-                if (direction != DOWN) direction = UP;
-                break;
-            case SDLK_DOWN:
-                if (direction != UP) direction = DOWN;
-                break;
-            case SDLK_LEFT:
-                if (direction != RIGHT) direction = LEFT;
-                break;
-            case SDLK_RIGHT:
-                if (direction != LEFT) direction = RIGHT;
-                break;
-            case SDLK_SPACE:
-            SDL_Quit();
-            break;
+            case SDLK_UP:    game.steer(0, -1); break;
+            case SDLK_DOWN:  game.steer(0, 1); break;
+            case SDLK_LEFT:  game.steer(-1, 0); break;
+            case SDLK_RIGHT: game.steer(1, 0); break;
+            case SDLK_SPACE: running = false; break;
         }
     }
 
     void update() {
-        
-        switch (direction) {
-            case UP:    snakeHead.y -= TILE_SIZE; break;
-            case DOWN:  snakeHead.y += TILE_SIZE; break;
-            case LEFT:  snakeHead.x -= TILE_SIZE; break;
-            case RIGHT: snakeHead.x += TILE_SIZE; break;
-        }
-
-        
-
-          if (snakeHead.x < 0 || snakeHead.y < 0 || 
-            snakeHead.x >= WINDOW_WIDTH || snakeHead.y >= WINDOW_HEIGHT) {
-            gameOver(); // End the game if snake hits the wall
-            return;
-            }
-        // 
-    //      if (snakeHead.x < 0)
-    // {
-    //     snakeHead.x =WINDOW_WIDTH ;
-    // }
-    // else if (snakeHead.x >= WINDOW_WIDTH)
-    // {
-    //     snakeHead.x = 0;
-    // }
-    //        if (snakeHead.y < 0)
-    // {
-    //     snakeHead.y =WINDOW_HEIGHT ;
-    // }
-    // else if (snakeHead.y >= WINDOW_HEIGHT)
-    // {
-    //     snakeHead.y = 0;
-    // }
-
-
-        for (const auto& segment : snakeBody) {
-            if (snakeHead.x == segment.x && snakeHead.y == segment.y) {
-                
-                gameOver();// End the game if snake hits itself
-            
-                return;
-            }
-        }
-
-        if (snakeHead.x == apple.x && snakeHead.y == apple.y) {
-            score++; 
-            snakeSize++; 
-            generateApple(); 
+        if (game.step() == rules::DIED) {
+            gameOver(); // the snake hit the wall or itself
         }
+    }
 
-       
-        snakeBody.push_front(snakeHead); 
-        while (snakeBody.size() > static_cast<size_t>(snakeSize)) {
-            snakeBody.pop_back();
-        }
+    // The tile at p, in pixels.
+    static SDL_Rect tileRect(SDL_Point p) {
+        return {p.x * TILE_SIZE, p.y * TILE_SIZE, TILE_SIZE, TILE_SIZE};
     }
 
     void render() {
@@ -170,60 +98,39 @@ private:
 
        
         SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
+        SDL_Rect apple = tileRect(game.food());
         SDL_RenderFillRect(renderer, &apple);
 
         
         SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255); 
-        for (const auto& segment : snakeBody) {
+        for (size_t i = 0; i < game.size(); ++i) {
+            SDL_Rect segment = tileRect(game.segment(i));
             SDL_RenderFillRect(renderer, &segment);
         }
 
         
         SDL_RenderPresent(renderer);
     }
-    
-void generateApple() {
-    // Ensure the apple's position is inside the window boundaries, leaving room for its size
-    apple.x = (rand() % ((WINDOW_WIDTH / TILE_SIZE) - 1)) * TILE_SIZE;
-    apple.y = (rand() % ((WINDOW_HEIGHT / TILE_SIZE) - 1)) * TILE_SIZE;
-
-    // Set the size of the apple
-    apple.w = TILE_SIZE;
-    apple.h = TILE_SIZE;
-}
-
-      void generateAppleWithTimer(int timeLimit) {
-        Uint32 currentTime = SDL_GetTicks();
-        if ((currentTime - lastAppleTime) >= (timeLimit * 1000)) {
-            generateApple();
-        }
-    }
 
      void gameOver() {
-        cout << "Game Over! Your Score: " << score << endl;
+        cout << "Game Over! Your Score: " << game.score() << endl;
         SDL_SetRenderDrawColor(renderer, 50, 25, 80, 255);
         SDL_RenderClear(renderer);
         SDL_RenderPresent(renderer);
         SDL_Delay(1000);
-        SDL_Quit();
-        resetGame();
-    }
-
-    void resetGame() {
-       
-        snakeHead = {WINDOW_WIDTH / 2, WINDOW_HEIGHT / 2, TILE_SIZE, TILE_SIZE};
-        snakeBody.clear();
-        snakeBody.push_back(snakeHead);
-        snakeSize = 1;
-        score = 0; 
-        direction = RIGHT;
-        generateApple();
+        game.reset();
     }
 };
 
 
+// --wrap: leaving the window brings the snake back on the other side.
 int SDL_main(int argc, char* argv[]) {
-    SnakeGame game;
-    game.run();
+    if (argc > 1 && string(argv[1]) == "--wrap") {
+        SnakeGame<rules::WrapGame> game;
+        game.run();
+    } else {
+        SnakeGame<rules::ClassicGame> game;
+        game.run();
+    }
     return 0;
 }
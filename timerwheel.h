@@ -0,0 +1,156 @@
+// Timed game events keyed on simulation ticks: bonus food running out,
+// power-ups wearing off, speed changes, obstacles appearing.
+//
+// A hierarchical timing wheel: level l has 64 slots of 64^l ticks each, so
+// scheduling is one list insert whatever the delay, and a tick looks at one
+// slot of level 0 plus, every 64^l ticks, one slot of level l, whose timers
+// move down a level. Nothing scans the pending timers, so thousands of them
+// cost the same per tick as one. Eleven levels cover every 64-bit tick.
+//
+// Ticks rather than wall time keep timers deterministic: a replay or a
+// headless run sees the same expirations, and a paused game's timers wait.
+//
+// Timers live in a pool indexed by their handle and are reused; a handle
+// carries the generation of its slot, so cancelling a timer that already
+// fired does nothing. The pool only allocates when it grows; reserve() the
+// most timers expected to keep steady play allocation-free.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct TimerHandle {
+    uint32_t index = ~0u;
+    uint32_t generation = 0;
+};
+
+template <class Event>
+class TimerWheel {
+public:
+    TimerWheel() { heads.assign(LISTS, NONE); }
+
+    void reserve(size_t timers) { nodes.reserve(timers); }
+
+    // Fires during the advance() that reaches tick `at`, or the next one if
+    // that is already past.
+    TimerHandle schedule(uint64_t at, const Event &event) {
+        uint32_t i = freeList;
+        if (i != NONE) {
+            freeList = nodes[i].next;
+        } else {
+            i = uint32_t(nodes.size());
+            nodes.push_back(Node());
+        }
+        Node &n = nodes[i];
+        n.at = at > tick ? at : tick + 1;
+        n.event = event;
+        n.live = true;
+        link(i, listFor(n.at));
+        count++;
+        return {i, n.generation};
+    }
+
+    TimerHandle after(uint64_t ticks, const Event &event) { return schedule(tick + ticks, event); }
+
+    // Whether the timer had yet to fire.
+    bool cancel(TimerHandle h) {
+        if (!pending(h)) return false;
+        unlink(h.index);
+        release(h.index);
+        return true;
+    }
+
+    bool pending(TimerHandle h) const {
+        return h.index < nodes.size() && nodes[h.index].live && nodes[h.index].generation == h.generation;
+    }
+
+    // The tick a pending timer fires on.
+    uint64_t dueAt(TimerHandle h) const { return nodes[h.index].at; }
+
+    // Moves on one tick and calls fire(event) for each timer due on it.
+    // fire may schedule and cancel timers, including others due now.
+    template <class F>
+    void advance(F &&fire) {
+        tick++;
+        for (int level = 1; level < LEVELS && (tick & ((uint64_t(1) << (BITS * level)) - 1)) == 0; ++level) {
+            uint32_t list = uint32_t(level * SLOTS + (tick >> (BITS * level) & MASK));
+            while (heads[list] != NONE) {
+                uint32_t i = heads[list];
+                unlink(i);
+                link(i, listFor(nodes[i].at));
+            }
+        }
+
+        // The due timers move to a list of their own, so fire can cancel
+        // any of them and schedule into this tick's slot.
+        uint32_t slot = uint32_t(tick & MASK);
+        heads[FIRING] = heads[slot];
+        for (uint32_t i = heads[slot]; i != NONE; i = nodes[i].next) nodes[i].list = FIRING;
+        heads[slot] = NONE;
+        while (heads[FIRING] != NONE) {
+            uint32_t i = heads[FIRING];
+            unlink(i);
+            Event event = nodes[i].event;
+            release(i);
+            fire(event);
+        }
+    }
+
+    uint64_t now() const { return tick; }
+    size_t size() const { return count; }
+
+private:
+    static const int BITS = 6, SLOTS = 1 << BITS, LEVELS = (64 + BITS - 1) / BITS;
+    static const uint64_t MASK = SLOTS - 1;
+    static const uint32_t NONE = ~0u, FIRING = LEVELS * SLOTS, LISTS = FIRING + 1;
+
+    struct Node {
+        uint64_t at = 0;
+        Event event{};
+        uint32_t prev = NONE, next = NONE;
+        uint32_t list = NONE;
+        uint32_t generation = 0;
+        bool live = false;
+    };
+
+    // The lowest level whose slot for `at` is still ahead of the current
+    // tick: above it, `at` and the current tick agree.
+    uint32_t listFor(uint64_t at) const {
+        uint64_t differ = at ^ tick;
+        int level = 0;
+        while (level + 1 < LEVELS && differ >> (BITS * (level + 1))) level++;
+        return uint32_t(level * SLOTS + (at >> (BITS * level) & MASK));
+    }
+
+    void link(uint32_t i, uint32_t list) {
+        Node &n = nodes[i];
+        n.list = list;
+        n.prev = NONE;
+        n.next = heads[list];
+        if (n.next != NONE) nodes[n.next].prev = i;
+        heads[list] = i;
+    }
+
+    void unlink(uint32_t i) {
+        Node &n = nodes[i];
+        if (n.prev != NONE) nodes[n.prev].next = n.next;
+        else heads[n.list] = n.next;
+        if (n.next != NONE) nodes[n.next].prev = n.prev;
+    }
+
+    void release(uint32_t i) {
+        Node &n = nodes[i];
+        n.live = false;
+        n.generation++;
+        n.next = freeList;
+        freeList = i;
+        count--;
+    }
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> heads; // per list, the first timer
+    uint32_t freeList = NONE;
+    uint64_t tick = 0;
+    size_t count = 0;
+};